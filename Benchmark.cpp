@@ -0,0 +1,903 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <regex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "sources/ConcurrentMagicalContainer.hpp"
+#include "sources/MagicalContainer.hpp"
+
+using namespace ariel;
+
+namespace
+{
+    /**
+     * @brief Keeps the compiler from optimizing a value (and the work producing it) away.
+     * @param value The value to keep.
+     */
+    template <typename T>
+    void doNotOptimize(const T &value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * @class Timer
+     * @brief Accumulates wall-clock and CPU time over the timed regions of a benchmark.
+     *
+     * Benchmarks call start() and stop() around the work they measure, so the setup of each
+     * iteration (building the container to remove from, shuffling inputs) is not counted.
+     */
+    class Timer
+    {
+    private:
+        std::chrono::steady_clock::time_point real_start;
+        std::clock_t cpu_start = 0;
+        double real_total = 0; /**< Seconds of wall-clock time. */
+        double cpu_total = 0;  /**< Seconds of CPU time. */
+        std::size_t items = 0; /**< Items processed, as reported by the benchmark. */
+
+    public:
+        void start()
+        {
+            real_start = std::chrono::steady_clock::now();
+            cpu_start = std::clock();
+        }
+
+        void stop()
+        {
+            cpu_total += static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+            real_total += std::chrono::duration<double>(std::chrono::steady_clock::now() - real_start).count();
+        }
+
+        void addItems(std::size_t count)
+        {
+            items += count;
+        }
+
+        double realSeconds() const
+        {
+            return real_total;
+        }
+
+        double cpuSeconds() const
+        {
+            return cpu_total;
+        }
+
+        std::size_t itemsProcessed() const
+        {
+            return items;
+        }
+    };
+
+    /**
+     * @struct Benchmark
+     * @brief A registered benchmark: one call of body is one iteration.
+     */
+    struct Benchmark
+    {
+        std::string name;                  /**< Name in the Google Benchmark form BM_Case<Storage>/variant/size. */
+        std::function<void(Timer &)> body; /**< Runs one iteration, timing its hot part and counting its items. */
+    };
+
+    /**
+     * @struct Result
+     * @brief The measurement of one benchmark.
+     */
+    struct Result
+    {
+        std::string name;
+        std::size_t iterations;
+        double real_time; /**< Nanoseconds of wall-clock time per iteration. */
+        double cpu_time;  /**< Nanoseconds of CPU time per iteration. */
+        double items_per_second;
+    };
+
+    /**
+     * @struct Options
+     * @brief Command line options, named after Google Benchmark's.
+     */
+    struct Options
+    {
+        std::string format = "console"; /**< --benchmark_format: console or json. */
+        std::string out;                /**< --benchmark_out: also write JSON to this file. */
+        std::regex filter{".*"};        /**< --benchmark_filter: only run matching benchmarks. */
+        double min_time = 0.1;          /**< --benchmark_min_time: timed seconds per benchmark. */
+        std::size_t max_size = 10000000; /**< --max_size: largest container size. */
+        std::size_t max_quadratic_size = 100000; /**< --max_quadratic_size: cap for O(N^2) cases. */
+    };
+
+    /**
+     * @brief The trial division test PrimeIterator used before the primality engine, kept as a baseline.
+     * @param value The value to check for primality.
+     * @return True if the value is prime, false otherwise.
+     */
+    bool trialDivisionIsPrime(int value)
+    {
+        if (value <= 1)
+        {
+            return false;
+        }
+        if (value == 2 || value == 3)
+        {
+            return true;
+        }
+        for (int i = 2; i <= std::sqrt(value); i++)
+        {
+            if (value % i == 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Returns the files written by the benchmarks, removed before the program exits.
+     * @return The list of paths.
+     */
+    std::vector<std::string> &temporaryFiles()
+    {
+        static std::vector<std::string> files;
+        return files;
+    }
+
+    /**
+     * @brief Returns n distinct values in random order.
+     * @param count The number of values.
+     * @param seed Seed of the shuffle.
+     * @return The values 0 .. count - 1, shuffled.
+     */
+    std::vector<int> shuffledValues(std::size_t count, unsigned seed)
+    {
+        std::vector<int> values(count);
+        std::iota(values.begin(), values.end(), 0);
+        std::shuffle(values.begin(), values.end(), std::mt19937(seed));
+        return values;
+    }
+
+    /**
+     * @brief Returns the values 0 .. count - 1 in a given order.
+     * @param order "sorted", "random" or "reverse".
+     * @param count The number of values.
+     * @param seed Seed of the random order.
+     * @return The values.
+     */
+    std::vector<int> orderedValues(const std::string &order, std::size_t count, unsigned seed)
+    {
+        if (order == "random")
+        {
+            return shuffledValues(count, seed);
+        }
+        std::vector<int> values(count);
+        std::iota(values.begin(), values.end(), 0);
+        if (order == "reverse")
+        {
+            std::reverse(values.begin(), values.end());
+        }
+        return values;
+    }
+
+    /**
+     * @brief Wraps a factory so its value is built on the first call and shared by the later ones.
+     * @param factory Builds the value.
+     * @return A callable returning a reference to the value, cheap to copy into several benchmarks.
+     *
+     * Benchmarks take their inputs through these, so registering them allocates nothing and a
+     * filtered run only builds what the selected benchmarks use.
+     */
+    template <typename Factory>
+    auto lazy(Factory factory)
+    {
+        using Value = std::invoke_result_t<Factory &>;
+        auto holder = std::make_shared<std::unique_ptr<const Value>>();
+        return [holder, factory]() -> const Value & {
+            if (*holder == nullptr)
+            {
+                *holder = std::make_unique<const Value>(factory());
+            }
+            return **holder;
+        };
+    }
+
+    /**
+     * @brief Returns a container holding the values 0 .. count - 1.
+     * @param count The number of elements.
+     * @return The container.
+     */
+    template <typename Container>
+    Container filledContainer(std::size_t count)
+    {
+        std::vector<int> values(count);
+        std::iota(values.begin(), values.end(), 0);
+        return Container(sorted_range, std::move(values));
+    }
+
+    /**
+     * @brief Returns the container sizes to benchmark: 10, 100, ... up to a limit.
+     * @param limit The largest size.
+     * @return The sizes.
+     */
+    std::vector<std::size_t> sizesUpTo(std::size_t limit)
+    {
+        std::vector<std::size_t> sizes;
+        for (std::size_t size = 10; size <= limit; size *= 10)
+        {
+            sizes.push_back(size);
+        }
+        return sizes;
+    }
+
+    /**
+     * @brief Registers the container benchmarks of one storage policy.
+     * @param benchmarks The list to append to.
+     * @param storage The storage name used in the benchmark names.
+     * @param options The size limits.
+     *
+     * Random and reverse insertions and removals shift the whole vector of a SortedVectorStorage,
+     * so for that storage they stop at max_quadratic_size. An EliasFanoStorage re-encodes itself
+     * on every update, so all of its single-element updates stop there.
+     */
+    template <typename Storage>
+    void registerContainer(std::vector<Benchmark> &benchmarks, const std::string &storage, const Options &options)
+    {
+        using Container = BasicMagicalContainer<Storage>;
+        constexpr bool reencodes = std::is_same_v<Storage, EliasFanoStorage>;
+        std::size_t quadratic_limit = Storage::is_contiguous || reencodes ? std::min(options.max_size, options.max_quadratic_size) : options.max_size;
+        auto label = [&storage](const std::string &name, const std::string &variant, std::size_t size) {
+            return "BM_" + name + "<" + storage + ">/" + variant + (variant.empty() ? "" : "/") + std::to_string(size);
+        };
+
+        for (std::size_t size : sizesUpTo(options.max_size))
+        {
+            std::vector<std::string> orders;
+            if (!reencodes || size <= quadratic_limit)
+            {
+                orders.emplace_back("sorted");
+            }
+            if (size <= quadratic_limit)
+            {
+                orders.emplace_back("random");
+                orders.emplace_back("reverse");
+            }
+            for (const std::string &order : orders)
+            {
+                benchmarks.push_back({label("AddElement", order, size), [values = lazy([order, size] { return orderedValues(order, size, 42); })](Timer &timer) {
+                                          Container container;
+                                          timer.start();
+                                          for (int value : values())
+                                          {
+                                              container.addElement(value);
+                                          }
+                                          timer.stop();
+                                          timer.addItems(values().size());
+                                          doNotOptimize(container.size());
+                                      }});
+            }
+
+            if (size <= quadratic_limit)
+            {
+                benchmarks.push_back({label("RemoveElement", "random", size), [size, order = lazy([size] { return shuffledValues(size, 7); })](Timer &timer) {
+                                          Container container = filledContainer<Container>(size);
+                                          timer.start();
+                                          for (int value : order())
+                                          {
+                                              container.removeElement(value);
+                                          }
+                                          timer.stop();
+                                          timer.addItems(order().size());
+                                          doNotOptimize(container.size());
+                                      }});
+            }
+
+            auto container = lazy([size] { return filledContainer<Container>(size); });
+
+            auto traverse = [container](auto order) {
+                return [container, order](Timer &timer) {
+                    auto traversal = order(container());
+                    long long sum = 0;
+                    std::size_t visited = 0;
+                    timer.start();
+                    for (int value : traversal)
+                    {
+                        sum += value;
+                        ++visited;
+                    }
+                    timer.stop();
+                    timer.addItems(visited);
+                    doNotOptimize(sum);
+                };
+            };
+            benchmarks.push_back({label("Traverse", "ascending", size), traverse([](const Container &target) { return target.ascending(); })});
+            benchmarks.push_back({label("Traverse", "side_cross", size), traverse([](const Container &target) { return target.sideCross(); })});
+            benchmarks.push_back({label("Traverse", "prime", size), traverse([](const Container &target) { return target.primes(); })});
+
+            // Startup from a snapshot against rebuilding from unsorted input. The mapped startup
+            // includes one ascending pass, since that is when its pages are actually read.
+            std::string snapshot_path = (std::filesystem::temp_directory_path() / ("magical_bench_" + storage + "_" + std::to_string(size) + ".bin")).string();
+            auto ensureSnapshot = [container, snapshot_path, saved = std::make_shared<bool>(false)] {
+                if (!*saved)
+                {
+                    container().save(snapshot_path);
+                    temporaryFiles().push_back(snapshot_path);
+                    *saved = true;
+                }
+            };
+            benchmarks.push_back({label("Startup", "snapshot", size), [ensureSnapshot, snapshot_path](Timer &timer) {
+                                      ensureSnapshot();
+                                      timer.start();
+                                      Container loaded = Container::load(snapshot_path);
+                                      timer.stop();
+                                      timer.addItems(loaded.size());
+                                      doNotOptimize(loaded.size());
+                                  }});
+            benchmarks.push_back({label("Startup", "mapped", size), [ensureSnapshot, snapshot_path](Timer &timer) {
+                                      ensureSnapshot();
+                                      timer.start();
+                                      auto mapped = MappedMagicalContainer<>::load(snapshot_path);
+                                      long long sum = 0;
+                                      for (int value : mapped.ascending())
+                                      {
+                                          sum += value;
+                                      }
+                                      timer.stop();
+                                      timer.addItems(mapped.size());
+                                      doNotOptimize(sum);
+                                  }});
+            benchmarks.push_back({label("Startup", "rebuild", size), [values = lazy([size] { return shuffledValues(size, 5); })](Timer &timer) {
+                                      timer.start();
+                                      Container rebuilt;
+                                      rebuilt.addElements(std::span<const int>(values()));
+                                      timer.stop();
+                                      timer.addItems(values().size());
+                                      doNotOptimize(rebuilt.size());
+                                  }});
+
+            // Aggregates against the iterator loops they replace
+            benchmarks.push_back({label("Sum", "iterator", size), [container](Timer &timer) {
+                                      long long sum = 0;
+                                      timer.start();
+                                      for (int value : container().ascending())
+                                      {
+                                          sum += value;
+                                      }
+                                      timer.stop();
+                                      timer.addItems(container().size());
+                                      doNotOptimize(sum);
+                                  }});
+            benchmarks.push_back({label("Sum", "aggregate", size), [container](Timer &timer) {
+                                      const Container &target = container();
+                                      timer.start();
+                                      doNotOptimize(target.sum());
+                                      timer.stop();
+                                      timer.addItems(target.size());
+                                  }});
+            auto low = static_cast<int>(size / 4);
+            auto high = static_cast<int>(size / 2);
+            benchmarks.push_back({label("CountInRange", "iterator", size), [container, low, high](Timer &timer) {
+                                      std::size_t count = 0;
+                                      timer.start();
+                                      for (int value : container().ascending())
+                                      {
+                                          count += (value >= low && value < high) ? 1U : 0U;
+                                      }
+                                      timer.stop();
+                                      timer.addItems(container().size());
+                                      doNotOptimize(count);
+                                  }});
+            benchmarks.push_back({label("CountInRange", "aggregate", size), [container, low, high](Timer &timer) {
+                                      const Container &target = container();
+                                      timer.start();
+                                      doNotOptimize(target.countInRange(low, high));
+                                      timer.stop();
+                                      timer.addItems(target.size());
+                                  }});
+
+            constexpr std::size_t calls = 1024;
+            auto beginEnd = [container](auto iterator_type) {
+                return [container](Timer &timer) {
+                    typename decltype(iterator_type)::type iterator(container());
+                    timer.start();
+                    for (std::size_t call = 0; call < calls; ++call)
+                    {
+                        doNotOptimize(iterator.begin());
+                        doNotOptimize(iterator.end());
+                    }
+                    timer.stop();
+                    timer.addItems(calls);
+                };
+            };
+            benchmarks.push_back({label("BeginEnd", "ascending", size), beginEnd(std::type_identity<typename Container::AscendingIterator>{})});
+            benchmarks.push_back({label("BeginEnd", "side_cross", size), beginEnd(std::type_identity<typename Container::SideCrossIterator>{})});
+            benchmarks.push_back({label("BeginEnd", "prime", size), beginEnd(std::type_identity<typename Container::PrimeIterator>{})});
+        }
+    }
+
+    /**
+     * @brief Registers the primality benchmarks.
+     * @param benchmarks The list to append to.
+     *
+     * Each test is run over random values below 2^16 and at or above 2^30.
+     */
+    void registerPrimality(std::vector<Benchmark> &benchmarks)
+    {
+        auto draw = [](std::size_t count, int low, int high) {
+            return lazy([count, low, high] {
+                std::mt19937 generator(42);
+                std::uniform_int_distribution<int> distribution(low, high);
+                std::vector<int> values(count);
+                for (int &value : values)
+                {
+                    value = distribution(generator);
+                }
+                return values;
+            });
+        };
+        auto small_values = draw(std::size_t{1} << 16U, 0, 1 << 16);
+        auto large_values = draw(std::size_t{1} << 12U, 1 << 30, std::numeric_limits<int>::max());
+
+        auto measure = [](auto values, bool (*test)(int)) {
+            return [values, test](Timer &timer) {
+                const std::vector<int> &inputs = values();
+                std::size_t primes = 0;
+                timer.start();
+                for (int value : inputs)
+                {
+                    primes += test(value) ? 1U : 0U;
+                }
+                timer.stop();
+                timer.addItems(inputs.size());
+                doNotOptimize(primes);
+            };
+        };
+        auto sieve = [](int value) {
+            if (!PrimeSieve::enabled())
+            {
+                PrimeSieve::enable();
+            }
+            return PrimeSieve::lookup(value).value_or(false);
+        };
+
+        benchmarks.push_back({"BM_IsPrime/trial_division/small", measure(small_values, trialDivisionIsPrime)});
+        benchmarks.push_back({"BM_IsPrime/primality/small", measure(small_values, primality::isPrime)});
+        benchmarks.push_back({"BM_IsPrime/sieve/small", measure(small_values, sieve)});
+        benchmarks.push_back({"BM_IsPrime/trial_division/large", measure(large_values, trialDivisionIsPrime)});
+        benchmarks.push_back({"BM_IsPrime/primality/large", measure(large_values, primality::isPrime)});
+
+        auto filter = [](auto values, bool batch) {
+            return [values, batch](Timer &timer) {
+                const std::vector<int> &inputs = values();
+                std::vector<int> primes;
+                timer.start();
+                if (batch)
+                {
+                    primes = primality::filterPrimes(inputs);
+                }
+                else
+                {
+                    std::copy_if(inputs.begin(), inputs.end(), std::back_inserter(primes), primality::isPrime);
+                }
+                timer.stop();
+                timer.addItems(inputs.size());
+                doNotOptimize(primes.size());
+            };
+        };
+        benchmarks.push_back({"BM_FilterPrimes/per_element/small", filter(small_values, false)});
+        benchmarks.push_back({"BM_FilterPrimes/batch/small", filter(small_values, true)});
+        benchmarks.push_back({"BM_FilterPrimes/per_element/large", filter(large_values, false)});
+        benchmarks.push_back({"BM_FilterPrimes/batch/large", filter(large_values, true)});
+    }
+
+    /**
+     * @brief Registers the benchmarks of every sum kernel the CPU supports.
+     * @param benchmarks The list to append to.
+     * @param options The size limit.
+     */
+    void registerAggregates(std::vector<Benchmark> &benchmarks, const Options &options)
+    {
+        const std::pair<const char *, aggregates::SimdLevel> kernels[] = {
+            {"scalar", aggregates::SimdLevel::Scalar},
+            {"sse41", aggregates::SimdLevel::Sse41},
+            {"avx2", aggregates::SimdLevel::Avx2},
+        };
+        for (std::size_t size : sizesUpTo(options.max_size))
+        {
+            auto values = lazy([size] { return shuffledValues(size, 3); });
+            for (const auto &[name, level] : kernels)
+            {
+                if (level > aggregates::detectedLevel())
+                {
+                    continue;
+                }
+                benchmarks.push_back({std::string("BM_SumKernel/") + name + "/" + std::to_string(size), [values, level = level](Timer &timer) {
+                                          const std::vector<int> &inputs = values();
+                                          timer.start();
+                                          doNotOptimize(aggregates::sum(inputs, level));
+                                          timer.stop();
+                                          timer.addItems(inputs.size());
+                                      }});
+            }
+        }
+    }
+
+    /**
+     * @brief Returns a random subset of a value range.
+     * @param range The values drawn from are 0 .. range - 1.
+     * @param one_in Every value is kept with probability 1 / one_in.
+     * @param seed Seed of the draw.
+     * @return The kept values, in ascending order.
+     */
+    std::vector<int> randomSubset(std::size_t range, unsigned one_in, unsigned seed)
+    {
+        std::mt19937 generator(seed);
+        std::vector<int> values;
+        for (std::size_t value = 0; value < range; ++value)
+        {
+            if (generator() % one_in == 0)
+            {
+                values.push_back(static_cast<int>(value));
+            }
+        }
+        return values;
+    }
+
+    /**
+     * @brief Registers the set operation benchmarks against the addElement loops they replace.
+     * @param benchmarks The list to append to.
+     * @param options The size limits. The addElement loops are O(N^2) and stop at max_quadratic_size.
+     *
+     * "similar" pairs two random halves of the same range, "skewed" pairs one with a 1/128 sample.
+     */
+    void registerSetAlgebra(std::vector<Benchmark> &benchmarks, const Options &options)
+    {
+        using Operation = MagicalContainer (MagicalContainer::*)(const MagicalContainer &) const;
+        const std::pair<const char *, Operation> operations[] = {
+            {"Intersect", &MagicalContainer::intersect},
+            {"Unite", &MagicalContainer::unite},
+            {"Subtract", &MagicalContainer::subtract},
+        };
+        for (std::size_t size : sizesUpTo(options.max_size))
+        {
+            auto subset = [size](unsigned one_in, unsigned seed) {
+                return lazy([size, one_in, seed] { return MagicalContainer(sorted_range, randomSubset(2 * size, one_in, seed)); });
+            };
+            auto lhs = subset(2, 1);
+            auto similar = subset(2, 2);
+            auto skewed = subset(128, 3);
+            for (const auto &[name, operation] : operations)
+            {
+                std::string prefix = std::string("BM_") + name + "/";
+                for (const auto &[shape, rhs] : {std::pair{"similar", similar}, std::pair{"skewed", skewed}})
+                {
+                    benchmarks.push_back({prefix + shape + "/" + std::to_string(size), [lhs, rhs = rhs, operation = operation](Timer &timer) {
+                                              const MagicalContainer &left = lhs();
+                                              const MagicalContainer &right = rhs();
+                                              timer.start();
+                                              MagicalContainer result = (left.*operation)(right);
+                                              timer.stop();
+                                              timer.addItems(left.size() + right.size());
+                                              doNotOptimize(result.size());
+                                          }});
+                }
+            }
+            if (size > options.max_quadratic_size)
+            {
+                continue;
+            }
+            benchmarks.push_back({"BM_Intersect/addElement/" + std::to_string(size), [lhs, similar](Timer &timer) {
+                                      const MagicalContainer &left = lhs();
+                                      const MagicalContainer &right = similar();
+                                      timer.start();
+                                      MagicalContainer result;
+                                      for (int value : left.ascending())
+                                      {
+                                          if (right.contains(value))
+                                          {
+                                              result.addElement(value);
+                                          }
+                                      }
+                                      timer.stop();
+                                      timer.addItems(left.size() + right.size());
+                                      doNotOptimize(result.size());
+                                  }});
+        }
+
+        const std::pair<const char *, aggregates::SimdLevel> kernels[] = {
+            {"scalar", aggregates::SimdLevel::Scalar},
+            {"avx2", aggregates::SimdLevel::Avx2},
+        };
+        for (std::size_t size : sizesUpTo(options.max_size))
+        {
+            auto lhs = lazy([size] { return randomSubset(2 * size, 2, 1); });
+            auto rhs = lazy([size] { return randomSubset(2 * size, 2, 2); });
+            for (const auto &[name, level] : kernels)
+            {
+                if (level > aggregates::detectedLevel())
+                {
+                    continue;
+                }
+                benchmarks.push_back({std::string("BM_IntersectKernel/") + name + "/" + std::to_string(size), [lhs, rhs, level = level](Timer &timer) {
+                                          const std::vector<int> &left = lhs();
+                                          const std::vector<int> &right = rhs();
+                                          timer.start();
+                                          std::vector<int> result = setalgebra::intersect(std::span<const int>(left), std::span<const int>(right), level);
+                                          timer.stop();
+                                          timer.addItems(left.size() + right.size());
+                                          doNotOptimize(result.size());
+                                      }});
+            }
+        }
+    }
+
+    /**
+     * @brief Registers the write and read benchmarks of ConcurrentMagicalContainer.
+     * @param benchmarks The list to append to.
+     * @param options The size limits. Every write copies the container, so they stop at max_quadratic_size.
+     *
+     * Each iteration writes 256 new elements into a container of the given size: from one
+     * thread, from four threads whose writes get combined, and from four producers merged in
+     * batches. "snapshot" measures the lock-free read of the current snapshot.
+     */
+    void registerConcurrent(std::vector<Benchmark> &benchmarks, const Options &options)
+    {
+        constexpr int writes = 256;
+        constexpr int threads = 4;
+        for (std::size_t size : sizesUpTo(std::min(options.max_size, options.max_quadratic_size)))
+        {
+            auto values = lazy([size] { return orderedValues("sorted", size, 0); });
+            auto first = static_cast<int>(size);
+            auto write = [values, first](auto body) {
+                return [values, first, body](Timer &timer) {
+                    ConcurrentMagicalContainer container;
+                    container.addElements(values());
+                    timer.start();
+                    body(container, first);
+                    timer.stop();
+                    timer.addItems(writes);
+                    doNotOptimize(container.size());
+                };
+            };
+            auto inThreads = [](auto work) {
+                std::vector<std::jthread> workers;
+                for (int thread = 0; thread < threads; ++thread)
+                {
+                    workers.emplace_back(work, thread);
+                }
+            };
+            std::string suffix = "/" + std::to_string(size);
+
+            benchmarks.push_back({"BM_ConcurrentAdd/single" + suffix, write([](ConcurrentMagicalContainer &container, int first) {
+                                      for (int value = first; value < first + writes; ++value)
+                                      {
+                                          container.addElement(value);
+                                      }
+                                  })});
+            benchmarks.push_back({"BM_ConcurrentAdd/contended" + suffix, write([inThreads](ConcurrentMagicalContainer &container, int first) {
+                                      inThreads([&container, first](int thread) {
+                                          for (int value = first + thread; value < first + writes; value += threads)
+                                          {
+                                              container.addElement(value);
+                                          }
+                                      });
+                                  })});
+            benchmarks.push_back({"BM_ConcurrentAdd/producers" + suffix, write([inThreads](ConcurrentMagicalContainer &container, int first) {
+                                      inThreads([&container, first](int thread) {
+                                          auto producer = container.producer();
+                                          for (int value = first + thread; value < first + writes; value += threads)
+                                          {
+                                              producer.push(value);
+                                          }
+                                      });
+                                      container.flush();
+                                  })});
+
+            benchmarks.push_back({"BM_ConcurrentSnapshot" + suffix, [values](Timer &timer) {
+                                      constexpr std::size_t calls = 1024;
+                                      ConcurrentMagicalContainer container;
+                                      container.addElements(values());
+                                      timer.start();
+                                      for (std::size_t call = 0; call < calls; ++call)
+                                      {
+                                          doNotOptimize(container.snapshot());
+                                      }
+                                      timer.stop();
+                                      timer.addItems(calls);
+                                  }});
+        }
+    }
+
+    /**
+     * @brief Runs a benchmark until its timed regions add up to the minimum time.
+     * @param benchmark The benchmark to run.
+     * @param min_time The minimum timed seconds.
+     * @return The measurement.
+     *
+     * Benchmarks with a slow setup also stop once ten times min_time of wall-clock time passed.
+     */
+    Result run(const Benchmark &benchmark, double min_time)
+    {
+        Timer timer;
+        std::size_t iterations = 0;
+        auto wall_start = std::chrono::steady_clock::now();
+        do
+        {
+            benchmark.body(timer);
+            ++iterations;
+        } while (timer.realSeconds() < min_time && std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count() < 10 * min_time);
+
+        auto per_iteration = static_cast<double>(iterations);
+        double items_per_second = timer.realSeconds() > 0 ? static_cast<double>(timer.itemsProcessed()) / timer.realSeconds() : 0;
+        return {benchmark.name, iterations, timer.realSeconds() * 1e9 / per_iteration, timer.cpuSeconds() * 1e9 / per_iteration, items_per_second};
+    }
+
+    /**
+     * @brief Writes the results in Google Benchmark's JSON format.
+     * @param out The stream to write to.
+     * @param results The measurements.
+     */
+    void writeJson(std::ostream &out, const std::vector<Result> &results)
+    {
+        std::time_t now = std::time(nullptr);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+#ifdef NDEBUG
+        const char *build_type = "release";
+#else
+        const char *build_type = "debug";
+#endif
+
+        out << "{\n  \"context\": {\n";
+        out << "    \"date\": \"" << date << "\",\n";
+        out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "    \"library_build_type\": \"" << build_type << "\",\n";
+        out << "    \"checked_iterators\": " << (MAGICAL_CHECKED_ITERATORS ? "true" : "false") << "\n";
+        out << "  },\n  \"benchmarks\": [\n";
+        out << std::setprecision(10);
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const Result &result = results[i];
+            out << "    {\n";
+            out << "      \"name\": \"" << result.name << "\",\n";
+            out << "      \"run_name\": \"" << result.name << "\",\n";
+            out << "      \"run_type\": \"iteration\",\n";
+            out << "      \"iterations\": " << result.iterations << ",\n";
+            out << "      \"real_time\": " << result.real_time << ",\n";
+            out << "      \"cpu_time\": " << result.cpu_time << ",\n";
+            out << "      \"time_unit\": \"ns\",\n";
+            out << "      \"items_per_second\": " << result.items_per_second << "\n";
+            out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+    /**
+     * @brief Prints one result as a line of the console table.
+     * @param result The measurement.
+     */
+    void printConsole(const Result &result)
+    {
+        std::cout << std::left << std::setw(48) << result.name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << result.real_time << " ns" << std::setw(14) << result.cpu_time << " ns"
+                  << std::setw(12) << result.iterations << "  items_per_second=" << std::scientific << std::setprecision(3)
+                  << result.items_per_second << std::endl;
+    }
+
+    /**
+     * @brief Parses the command line.
+     * @param argc Argument count.
+     * @param argv Arguments.
+     * @return The options.
+     * @throws std::runtime_error On an unknown option.
+     */
+    Options parseOptions(int argc, char **argv)
+    {
+        Options options;
+        std::vector<std::string> arguments(argv + 1, argv + argc);
+        for (const std::string &argument : arguments)
+        {
+            std::size_t equals = argument.find('=');
+            std::string key = argument.substr(0, equals);
+            std::string value = equals == std::string::npos ? "" : argument.substr(equals + 1);
+            if (key == "--benchmark_format")
+            {
+                options.format = value;
+            }
+            else if (key == "--benchmark_out")
+            {
+                options.out = value;
+            }
+            else if (key == "--benchmark_filter")
+            {
+                options.filter = std::regex(value);
+            }
+            else if (key == "--benchmark_min_time")
+            {
+                options.min_time = std::stod(value);
+            }
+            else if (key == "--max_size")
+            {
+                options.max_size = std::stoul(value);
+            }
+            else if (key == "--max_quadratic_size")
+            {
+                options.max_quadratic_size = std::stoul(value);
+            }
+            else
+            {
+                throw std::runtime_error("Unknown option " + argument);
+            }
+        }
+        return options;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    try
+    {
+        options = parseOptions(argc, argv);
+    }
+    catch (const std::exception &error)
+    {
+        std::cerr << error.what() << "\nUsage: " << argv[0]
+                  << " [--benchmark_format=console|json] [--benchmark_out=file] [--benchmark_filter=regex]"
+                     " [--benchmark_min_time=seconds] [--max_size=n] [--max_quadratic_size=n]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::vector<Benchmark> benchmarks;
+    registerContainer<SortedVectorStorage>(benchmarks, "SortedVector", options);
+    registerContainer<BPlusTreeStorage>(benchmarks, "BPlusTree", options);
+    registerContainer<EliasFanoStorage>(benchmarks, "EliasFano", options);
+    registerContainer<RoaringStorage>(benchmarks, "Roaring", options);
+    registerPrimality(benchmarks);
+    registerAggregates(benchmarks, options);
+    registerSetAlgebra(benchmarks, options);
+    registerConcurrent(benchmarks, options);
+
+    // The inputs are shared by the benchmarks using them and freed with the last one, so the
+    // filtered-out benchmarks go first and each body is dropped once it has run.
+    std::erase_if(benchmarks, [&options](const Benchmark &benchmark) { return !std::regex_search(benchmark.name, options.filter); });
+    std::vector<Result> results;
+    for (Benchmark &benchmark : benchmarks)
+    {
+        results.push_back(run(benchmark, options.min_time));
+        benchmark.body = nullptr;
+        if (options.format == "console")
+        {
+            printConsole(results.back());
+        }
+    }
+    PrimeSieve::disable();
+    for (const std::string &file : temporaryFiles())
+    {
+        std::filesystem::remove(file);
+    }
+
+    if (options.format == "json")
+    {
+        writeJson(std::cout, results);
+    }
+    if (!options.out.empty())
+    {
+        std::ofstream file(options.out);
+        writeJson(file, results);
+    }
+    return 0;
+}
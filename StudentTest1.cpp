@@ -1,6 +1,20 @@
 #include "doctest.h"
 #include "sources/MagicalContainer.hpp"
+#include "sources/ConcurrentMagicalContainer.hpp"
 #include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <ranges>
+#include <random>
+#include <set>
+#include <thread>
 
 using namespace ariel;
 using namespace std;
@@ -597,3 +611,1220 @@ TEST_CASE("operator= throws when iterators are pointing at different containers"
 }
 
 
+// Test case for adding many elements at once
+TEST_CASE("Bulk insertion into MagicalContainer") {
+    MagicalContainer container;
+    container.addElement(5);
+    container.addElement(20);
+
+    SUBCASE("Initializer list") {
+        container.addElements({15, 1, 30, 5});
+        CHECK(container.size() == 6);
+        MagicalContainer::AscendingIterator it(container);
+        CHECK(*it == 1);
+        ++it;
+        CHECK(*it == 5);
+        ++it;
+        CHECK(*it == 5);
+        ++it;
+        CHECK(*it == 15);
+        ++it;
+        CHECK(*it == 20);
+        ++it;
+        CHECK(*it == 30);
+    }
+
+    SUBCASE("Span and iterator pair") {
+        std::vector<int> values = {40, 10, 25};
+        container.addElements(values);
+        container.addElements(values.begin(), values.begin() + 1);
+        CHECK(container.size() == 6);
+        MagicalContainer::AscendingIterator it(container);
+        std::vector<int> seen;
+        for (auto iter = it.begin(); iter != it.end(); ++iter) {
+            seen.push_back(*iter);
+        }
+        CHECK(seen == std::vector<int>{5, 10, 20, 25, 40, 40});
+    }
+
+    SUBCASE("Adopting a sorted range") {
+        MagicalContainer adopted(sorted_range, {2, 3, 3, 8});
+        CHECK(adopted.size() == 4);
+        MagicalContainer::PrimeIterator it(adopted);
+        CHECK(*it == 2);
+        CHECK_THROWS_AS(MagicalContainer(sorted_range, {3, 2}), runtime_error);
+    }
+}
+
+// Test case for removing many elements at once
+TEST_CASE("Bulk removal from MagicalContainer") {
+    MagicalContainer container;
+    container.addElements({1, 2, 2, 3, 5, 8, 13});
+
+    SUBCASE("Removing existing elements") {
+        CHECK_NOTHROW(container.removeElements({13, 2, 1}));
+        CHECK(container.size() == 4);
+        MagicalContainer::AscendingIterator it(container);
+        CHECK(*it == 2);
+        ++it;
+        CHECK(*it == 3);
+    }
+
+    SUBCASE("Removing a missing element leaves the container unchanged") {
+        CHECK_THROWS_AS(container.removeElements({1, 4}), runtime_error);
+        CHECK_THROWS_AS(container.removeElements({3, 3}), runtime_error);
+        CHECK(container.size() == 7);
+    }
+
+    SUBCASE("Removing duplicates one at a time") {
+        container.removeElement(2);
+        container.removeElement(2);
+        CHECK_THROWS_AS(container.removeElement(2), runtime_error);
+        CHECK(container.size() == 5);
+    }
+}
+
+// Test case for the storage backends
+TEST_CASE_TEMPLATE("Iterators work on every storage backend", Storage, SortedVectorStorage, BPlusTreeStorage, EliasFanoStorage, RoaringStorage) {
+    BasicMagicalContainer<Storage> container;
+    container.addElements({9, 2, 17, 25, 3});
+
+    typename BasicMagicalContainer<Storage>::AscendingIterator ascending(container);
+    std::vector<int> seen;
+    for (auto it = ascending.begin(); it != ascending.end(); ++it) {
+        seen.push_back(*it);
+    }
+    CHECK(seen == std::vector<int>{2, 3, 9, 17, 25});
+
+    seen.clear();
+    typename BasicMagicalContainer<Storage>::SideCrossIterator cross(container);
+    for (auto it = cross.begin(); it != cross.end(); ++it) {
+        seen.push_back(*it);
+    }
+    CHECK(seen == std::vector<int>{2, 25, 3, 17, 9});
+
+    seen.clear();
+    typename BasicMagicalContainer<Storage>::PrimeIterator prime(container);
+    for (auto it = prime.begin(); it != prime.end(); ++it) {
+        seen.push_back(*it);
+    }
+    CHECK(seen == std::vector<int>{2, 3, 17});
+}
+
+TEST_CASE("B+tree storage matches a multiset under interleaved updates") {
+    BasicMagicalContainer<BPlusTreeStorage> container;
+    std::multiset<int> reference;
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> values(-500, 500);
+
+    auto contents = [&container]() {
+        std::vector<int> result;
+        BasicMagicalContainer<BPlusTreeStorage>::AscendingIterator it(container);
+        for (auto iter = it.begin(); iter != it.end(); ++iter) {
+            result.push_back(*iter);
+        }
+        return result;
+    };
+
+    for (int step = 0; step < 20000; ++step) {
+        int value = values(generator);
+        if (step % 3 == 2 && reference.count(value) > 0) {
+            container.removeElement(value);
+            reference.erase(reference.find(value));
+        } else {
+            container.addElement(value);
+            reference.insert(value);
+        }
+    }
+    CHECK(container.size() == reference.size());
+    CHECK(contents() == std::vector<int>(reference.begin(), reference.end()));
+
+    std::vector<int> batch = {1000, -1000, 0, 0, 7};
+    container.addElements(batch);
+    reference.insert(batch.begin(), batch.end());
+    container.removeElements({1000, 0});
+    reference.erase(reference.find(1000));
+    reference.erase(reference.find(0));
+    CHECK(contents() == std::vector<int>(reference.begin(), reference.end()));
+
+    std::vector<int> remaining(reference.begin(), reference.end());
+    std::shuffle(remaining.begin(), remaining.end(), generator);
+    for (std::size_t i = 0; i < remaining.size() / 2; ++i) {
+        container.removeElement(remaining[i]);
+        reference.erase(reference.find(remaining[i]));
+    }
+    CHECK(contents() == std::vector<int>(reference.begin(), reference.end()));
+    for (std::size_t i = remaining.size() / 2; i < remaining.size(); ++i) {
+        container.removeElement(remaining[i]);
+    }
+    CHECK(container.size() == 0);
+    CHECK_THROWS_AS(container.removeElement(7), runtime_error);
+}
+
+TEST_CASE("Elias-Fano storage decodes and searches like a sorted vector") {
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<int> gaps(0, 40);
+    std::vector<int> values;
+    int value = INT_MIN + 5;
+    for (int i = 0; i < 20000; ++i) {
+        value += gaps(generator);
+        values.push_back(value);
+    }
+    // Gaps of 20 on average take 2 + log2(20) bits per element
+    CHECK(EliasFanoStorage(values).bytes() * 4 < values.size() * sizeof(int));
+    values.push_back(INT_MAX);
+
+    EliasFanoStorage storage(values);
+    REQUIRE(storage.size() == values.size());
+    bool decoded = true;
+    for (std::size_t rank = 0; rank < values.size(); ++rank) {
+        decoded = decoded && storage[rank] == values[rank];
+    }
+    CHECK(decoded);
+
+    bool searched = true;
+    for (int probe : {INT_MIN, INT_MIN + 5, values[777], values[777] + 1, values[19999], INT_MAX - 1, INT_MAX}) {
+        auto lower = static_cast<std::size_t>(std::lower_bound(values.begin(), values.end(), probe) - values.begin());
+        auto upper = static_cast<std::size_t>(std::upper_bound(values.begin(), values.end(), probe) - values.begin());
+        searched = searched && storage.lowerBound(probe) == lower && storage.upperBound(probe) == upper;
+    }
+    for (int step = 0; step < 2000; ++step) {
+        int probe = values[static_cast<std::size_t>(step) * 10] + step % 3 - 1;
+        auto lower = static_cast<std::size_t>(std::lower_bound(values.begin(), values.end(), probe) - values.begin());
+        searched = searched && storage.lowerBound(probe) == lower;
+    }
+    CHECK(searched);
+
+    CHECK(storage.erase(INT_MAX));
+    CHECK_FALSE(storage.erase(INT_MAX));
+    storage.insert(-3);
+    values.pop_back();
+    values.insert(std::upper_bound(values.begin(), values.end(), -3), -3);
+    CHECK(storage[storage.lowerBound(-3)] == -3);
+    CHECK(storage.size() == values.size());
+
+    BasicMagicalContainer<EliasFanoStorage> container;
+    container.addElements({5, 5, 5, 5});
+    CHECK(container.count(5) == 4);
+    CHECK(std::ranges::equal(container.sideCross(), std::vector<int>{5, 5, 5, 5}));
+    container.removeElements({5, 5, 5, 5});
+    CHECK(container.size() == 0);
+}
+
+TEST_CASE("Roaring storage matches a set across every chunk layout") {
+    RoaringStorage storage;
+    std::set<int> reference;
+    std::mt19937 generator(13);
+
+    auto matches = [&storage, &reference]() {
+        if (storage.size() != reference.size()) {
+            return false;
+        }
+        std::size_t rank = 0;
+        for (int value : reference) {
+            if (storage[rank] != value || storage.lowerBound(value) != rank || storage.upperBound(value) != rank + 1) {
+                return false;
+            }
+            ++rank;
+        }
+        return true;
+    };
+
+    // Chunks grow from arrays into runs (random dense values) or a bitmap (every other value), then shrink back
+    std::uniform_int_distribution<int> dense(-70000, -60000);
+    for (int step = 0; step < 30000; ++step) {
+        int value = dense(generator);
+        if (reference.insert(value).second) {
+            storage.insert(value);
+        }
+    }
+    for (int value = 100000; value < 112000; value += 2) {
+        storage.insert(value);
+        reference.insert(value);
+    }
+    for (int value : {INT_MIN, -1, 0, 1, INT_MAX}) {
+        storage.insert(value);
+        reference.insert(value);
+    }
+    CHECK(matches());
+    std::vector<int> shuffled(reference.begin(), reference.end());
+    std::shuffle(shuffled.begin(), shuffled.end(), generator);
+    bool erased = true;
+    for (std::size_t i = 0; i < shuffled.size() * 3 / 4; ++i) {
+        erased = erased && storage.erase(shuffled[i]);
+        reference.erase(shuffled[i]);
+    }
+    CHECK(erased);
+    CHECK_FALSE(storage.erase(shuffled[0]));
+    CHECK(matches());
+    CHECK(storage.lowerBound(-59999) == static_cast<std::size_t>(std::distance(reference.begin(), reference.lower_bound(-59999))));
+
+    // A long range is kept as runs, and single updates split and join them
+    std::vector<int> range(200000);
+    std::iota(range.begin(), range.end(), 1000);
+    RoaringStorage runs(range);
+    CHECK(runs.bytes() < 1024);
+    CHECK(runs.erase(5000));
+    CHECK(runs.erase(5001));
+    CHECK(runs[4000] == 5002);
+    runs.insert(5001);
+    CHECK(runs[4000] == 5001);
+    CHECK(runs[4001] == 5002);
+    CHECK(runs.size() == 199999);
+    CHECK(runs.lowerBound(5000) == 4000);
+    CHECK(runs.upperBound(200999) == 199999);
+
+    BasicMagicalContainer<RoaringStorage> container;
+    container.addElements({7, 7, 11, 12});
+    container.addElement(11);
+    CHECK(container.size() == 5);
+    CHECK(container.count(11) == 2);
+    CHECK(std::ranges::equal(container.primes(), std::vector<int>{7, 7, 11, 11}));
+    container.removeElements({7, 7});
+    CHECK(std::ranges::equal(container.ascending(), std::vector<int>{11, 11, 12}));
+    CHECK_THROWS_AS(container.removeElement(7), runtime_error);
+}
+
+TEST_CASE("Roaring storage keeps repeated values like a multiset") {
+    RoaringStorage storage;
+    std::multiset<int> reference;
+    std::mt19937 generator(24);
+    std::uniform_int_distribution<int> values(-200000, 200000);
+
+    auto matches = [&storage, &reference]() {
+        if (storage.size() != reference.size()) {
+            return false;
+        }
+        std::size_t rank = 0;
+        for (int value : reference) {
+            auto below = static_cast<std::size_t>(std::distance(reference.begin(), reference.lower_bound(value)));
+            if (storage[rank] != value || storage.lowerBound(value) != below || storage.upperBound(value) != below + reference.count(value)) {
+                return false;
+            }
+            ++rank;
+        }
+        return true;
+    };
+
+    // Repeats spread over many chunks, then a batch large enough to rebuild them
+    std::vector<int> drawn;
+    for (int step = 0; step < 3000; ++step) {
+        int value = values(generator) / 64;
+        storage.insert(value);
+        reference.insert(value);
+        drawn.push_back(value);
+    }
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        storage.insert(INT_MAX);
+        reference.insert(INT_MAX);
+    }
+    CHECK(matches());
+    std::sort(drawn.begin(), drawn.end());
+    storage.insertSorted(drawn);
+    reference.insert(drawn.begin(), drawn.end());
+    CHECK(matches());
+
+    std::shuffle(drawn.begin(), drawn.end(), generator);
+    bool erased = true;
+    for (std::size_t i = 0; i < drawn.size() / 2; ++i) {
+        erased = erased && storage.erase(drawn[i]);
+        reference.erase(reference.find(drawn[i]));
+    }
+    CHECK(erased);
+    CHECK(matches());
+    std::vector<int> rest(drawn.begin() + static_cast<std::ptrdiff_t>(drawn.size() / 2), drawn.end());
+    std::sort(rest.begin(), rest.end());
+    storage.eraseSorted(rest);
+    for (int value : rest) {
+        reference.erase(reference.find(value));
+    }
+    CHECK(matches());
+    CHECK(storage.size() == drawn.size() + 3);
+}
+
+// Test case for the prime index kept by the container
+TEST_CASE("PrimeIterator follows additions and removals") {
+    MagicalContainer container;
+    container.addElements({4, 7, 9, 11, 11, 15});
+
+    auto primes = [&container]() {
+        std::vector<int> result;
+        MagicalContainer::PrimeIterator it(container);
+        for (auto iter = it.begin(); iter != it.end(); ++iter) {
+            result.push_back(*iter);
+        }
+        return result;
+    };
+
+    CHECK(primes() == std::vector<int>{7, 11, 11});
+    container.addElement(2);
+    container.removeElement(11);
+    CHECK(primes() == std::vector<int>{2, 7, 11});
+    container.removeElements({7, 9, 2});
+    CHECK(primes() == std::vector<int>{11});
+    container.removeElement(11);
+    MagicalContainer::PrimeIterator it(container);
+    CHECK(it == it.end());
+    CHECK(container.size() == 2);
+}
+
+// Test case for the primality engine
+TEST_CASE("Primality engine agrees with trial division") {
+    auto trialDivision = [](int value) {
+        if (value < 2) {
+            return false;
+        }
+        for (int divisor = 2; divisor <= value / divisor; ++divisor) {
+            if (value % divisor == 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    bool agrees = true;
+    for (int value = -10; value < 200000 && agrees; ++value) {
+        agrees = primality::isPrime(value) == trialDivision(value);
+    }
+    CHECK(agrees);
+
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<int> large(1 << 30, std::numeric_limits<int>::max());
+    for (int i = 0; i < 2000 && agrees; ++i) {
+        int value = large(generator);
+        agrees = primality::isPrime(value) == trialDivision(value);
+    }
+    CHECK(agrees);
+
+    // Carmichael numbers and strong pseudoprimes to several bases
+    for (int composite : {561, 1105, 41041, 825265, 2047, 1373653, 25326001, 1194649}) {
+        CHECK_FALSE(primality::isPrime(composite));
+    }
+    CHECK(primality::isPrime(2147483647));
+    CHECK_FALSE(primality::isPrime(2147483646));
+    CHECK_FALSE(primality::isPrime(std::numeric_limits<int>::min()));
+}
+
+TEST_CASE("Batch prime filter agrees with isPrime") {
+    std::vector<int> values;
+    for (int value = -20; value < 5000; ++value) {
+        values.push_back(value);
+    }
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<int> any(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    for (int i = 0; i < 20003; ++i) {
+        values.push_back(any(generator));
+    }
+    values.push_back(2147483647);
+    values.push_back(25326001);
+
+    std::vector<int> expected;
+    std::copy_if(values.begin(), values.end(), std::back_inserter(expected), primality::isPrime);
+    CHECK(primality::filterPrimes(values) == expected);
+    CHECK(primality::filterPrimes(std::span<const int>(values.data(), 5)).empty());
+}
+
+// Test case for the shared prime sieve
+TEST_CASE("PrimeSieve answers inside its ceiling only") {
+    PrimeSieve::enable(std::size_t{1} << 16U);
+    CHECK(PrimeSieve::enabled());
+    CHECK(PrimeSieve::memoryUsage() == 0);
+
+    bool agrees = true;
+    for (int value = -5; value < 300000 && agrees; ++value) {
+        std::optional<bool> known = PrimeSieve::lookup(value);
+        agrees = known.has_value() && *known == primality::isPrime(value);
+    }
+    CHECK(agrees);
+    CHECK(PrimeSieve::memoryUsage() <= (std::size_t{1} << 16U));
+    CHECK_FALSE(PrimeSieve::lookup(2147483647).has_value());
+
+    MagicalContainer container;
+    container.addElements({1, 2, 9, 97, 2147483647});
+    MagicalContainer::PrimeIterator it(container);
+    CHECK(*it == 2);
+    ++it;
+    CHECK(*it == 97);
+    ++it;
+    CHECK(*it == 2147483647);
+
+    PrimeSieve::disable();
+    CHECK_FALSE(PrimeSieve::enabled());
+    CHECK_FALSE(PrimeSieve::lookup(97).has_value());
+}
+
+// Test case for the type-erased iterator interface
+TEST_CASE("Erased_Iterator compares through Mystical_Iterator") {
+    MagicalContainer container;
+    container.addElements({1, 2, 3, 4});
+    MagicalContainer other;
+
+    Erased_Iterator<MagicalContainer::AscendingIterator> first(MagicalContainer::AscendingIterator{container});
+    Erased_Iterator<MagicalContainer::AscendingIterator> second(MagicalContainer::AscendingIterator{container});
+    Erased_Iterator<MagicalContainer::PrimeIterator> prime(MagicalContainer::PrimeIterator{container});
+    Erased_Iterator<MagicalContainer::AscendingIterator> foreign(MagicalContainer::AscendingIterator{other});
+
+    const Mystical_Iterator &lhs = first;
+    const Mystical_Iterator &rhs = second;
+    CHECK(lhs == rhs);
+    ++second.get();
+    CHECK(lhs != rhs);
+    CHECK(lhs < rhs);
+    CHECK(rhs > lhs);
+    CHECK(first.get() < second.get());
+    CHECK_THROWS_AS((void)(lhs == prime), runtime_error);
+    CHECK_THROWS_AS((void)(lhs == foreign), runtime_error);
+}
+
+// Test case for the standard iterator concepts
+static_assert(std::contiguous_iterator<MagicalContainer::AscendingIterator>);
+static_assert(std::random_access_iterator<BasicMagicalContainer<BPlusTreeStorage>::AscendingIterator>);
+static_assert(std::random_access_iterator<BasicMagicalContainer<EliasFanoStorage>::AscendingIterator>);
+static_assert(std::random_access_iterator<BasicMagicalContainer<RoaringStorage>::AscendingIterator>);
+static_assert(std::is_same_v<std::iterator_traits<MagicalContainer::AscendingIterator>::iterator_category, std::random_access_iterator_tag>);
+static_assert(std::is_same_v<std::iterator_traits<BasicMagicalContainer<EliasFanoStorage>::AscendingIterator>::iterator_category, std::input_iterator_tag>);
+static_assert(std::is_same_v<std::iterator_traits<BasicMagicalContainer<RoaringStorage>::PrimeIterator>::iterator_category, std::input_iterator_tag>);
+static_assert(std::random_access_iterator<BasicMagicalContainer<EliasFanoStorage>::SideCrossIterator>);
+static_assert(std::bidirectional_iterator<BasicMagicalContainer<RoaringStorage>::PrimeIterator>);
+static_assert(std::bidirectional_iterator<MagicalContainer::SideCrossIterator>);
+static_assert(std::bidirectional_iterator<MagicalContainer::PrimeIterator>);
+static_assert(std::sized_sentinel_for<std::default_sentinel_t, MagicalContainer::AscendingIterator>);
+static_assert(std::sentinel_for<std::default_sentinel_t, MagicalContainer::PrimeIterator>);
+
+TEST_CASE("Iterators work with standard algorithms") {
+    MagicalContainer container;
+    container.addElements({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+
+    SUBCASE("AscendingIterator") {
+        MagicalContainer::AscendingIterator it(container);
+        CHECK(std::accumulate(it.begin(), it.end(), 0) == 55);
+        CHECK(std::ranges::distance(container.ascending()) == 10);
+        CHECK(it[3] == 4);
+        CHECK(*(it + 9) == 10);
+        CHECK((it.end() - it) == 10);
+        CHECK(*std::ranges::lower_bound(container.ascending(), 7) == 7);
+        CHECK(std::to_address(it.end()) == std::to_address(it) + 10);
+        auto previous = it++;
+        CHECK(*previous == 1);
+        CHECK(*it-- == 2);
+        CHECK_THROWS_AS(--it, runtime_error);
+        CHECK_THROWS_AS(it += 11, runtime_error);
+    }
+
+    SUBCASE("SideCrossIterator and PrimeIterator") {
+        std::vector<int> cross;
+        std::ranges::copy(container.sideCross(), std::back_inserter(cross));
+        CHECK(cross == std::vector<int>{1, 10, 2, 9, 3, 8, 4, 7, 5, 6});
+        CHECK(std::ranges::count_if(container.primes(), [](int value) { return value > 3; }) == 2);
+
+        MagicalContainer::PrimeIterator it(container);
+        it++;
+        CHECK(*it == 3);
+        --it;
+        CHECK(*it == 2);
+        int sum = 0;
+        for (auto iter = container.primes().begin(); iter != std::default_sentinel; ++iter) {
+            sum += *iter;
+        }
+        CHECK(sum == 17);
+    }
+
+    SUBCASE("Default constructed iterators can be assigned") {
+        MagicalContainer::AscendingIterator it;
+        it = MagicalContainer::AscendingIterator(container);
+        CHECK(*it == 1);
+    }
+}
+
+// Test case for random access on the side-cross order
+static_assert(std::random_access_iterator<MagicalContainer::SideCrossIterator>);
+
+TEST_CASE("SideCrossIterator jumps in constant time") {
+    MagicalContainer container;
+    container.addElements({1, 2, 3, 4, 5, 6, 7});
+    std::vector<int> expected = {1, 7, 2, 6, 3, 5, 4};
+
+    MagicalContainer::SideCrossIterator it(container);
+    for (std::size_t k = 0; k < expected.size(); ++k) {
+        CHECK(it[static_cast<std::ptrdiff_t>(k)] == expected[k]);
+    }
+    CHECK(*(it + 5) == 5);
+    CHECK(std::distance(it.begin(), it.end()) == 7);
+    CHECK(std::ranges::distance(container.sideCross()) == 7);
+
+    it += 4;
+    CHECK(*it == 3);
+    it -= 3;
+    CHECK(*it == 7);
+    CHECK((it.end() - it) == 6);
+    CHECK_THROWS_AS(it += 7, runtime_error);
+
+    // Split the traversal in two halves, as two workers would
+    auto begin = container.sideCross().begin();
+    auto middle = begin + 3;
+    std::vector<int> first(begin, middle);
+    std::vector<int> second(middle, begin.end());
+    first.insert(first.end(), second.begin(), second.end());
+    CHECK(first == expected);
+}
+
+// Test case for the parallel traversals
+TEST_CASE("Parallel traversal covers every order") {
+    MagicalContainer container;
+    std::vector<int> values(10000);
+    std::iota(values.begin(), values.end(), 1);
+    container.addElements(values);
+
+    std::atomic<long long> sum{0};
+    container.parallelForEach(TraversalOrder::Ascending, [&sum](int value) { sum += value; }, 4);
+    CHECK(sum == 50005000LL);
+
+    sum = 0;
+    container.parallelForEach(TraversalOrder::SideCross, [&sum](int value) { sum += value; }, 3);
+    CHECK(sum == 50005000LL);
+
+    auto chunks = container.primeChunks(4);
+    CHECK(chunks.size() == 4);
+    CHECK(std::ranges::distance(chunks[0]) + 1 >= std::ranges::distance(chunks[3]));
+    CHECK(*chunks[1].begin() > *std::prev(chunks[0].end()));
+
+    std::atomic<std::size_t> primes{0};
+    container.parallelForEachChunk(TraversalOrder::Prime, [&primes](const auto &chunk) { primes += static_cast<std::size_t>(std::ranges::distance(chunk)); }, 4);
+    CHECK(primes == 1229);
+
+    CHECK_THROWS_AS(container.parallelForEach(TraversalOrder::Prime, [](int value) {
+        if (value == 7919) {
+            throw std::runtime_error("stop");
+        }
+    }, 4), runtime_error);
+
+    MagicalContainer empty;
+    CHECK(empty.ascendingChunks(4).empty());
+    CHECK_NOTHROW(empty.parallelForEach(TraversalOrder::Prime, [](int) {}));
+}
+
+TEST_CASE("Parallel traversal only starts threads for large enough chunks") {
+    auto chunkThreads = [](const MagicalContainer &container, std::size_t threads) {
+        std::mutex mutex;
+        std::vector<std::thread::id> ids;
+        container.parallelForEachChunk(TraversalOrder::Ascending, [&mutex, &ids](const auto &) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.push_back(std::this_thread::get_id());
+        }, threads);
+        return ids;
+    };
+
+    MagicalContainer small;
+    std::vector<int> values(2 * min_chunk_elements - 1);
+    std::iota(values.begin(), values.end(), 0);
+    small.addElements(values);
+    CHECK(chunkThreads(small, 8) == std::vector<std::thread::id>{std::this_thread::get_id()});
+
+    MagicalContainer large;
+    values.resize(3 * min_chunk_elements);
+    std::iota(values.begin(), values.end(), 0);
+    large.addElements(values);
+    auto ids = chunkThreads(large, 8);
+    CHECK(ids.size() == 3);
+    CHECK(std::set<std::thread::id>(ids.begin(), ids.end()).size() == 3);
+    CHECK(chunkThreads(large, 2).size() == 2);
+
+    std::atomic<long long> sum{0};
+    large.parallelForEach(TraversalOrder::SideCross, [&sum](int value) { sum += value; }, 8);
+    CHECK(sum == static_cast<long long>(values.size()) * static_cast<long long>(values.size() - 1) / 2);
+}
+
+// Test case for the snapshot-based concurrent container
+TEST_CASE("ConcurrentMagicalContainer pins snapshots") {
+    ConcurrentMagicalContainer container;
+    container.addElements({5, 2, 9, 4});
+
+    auto collect = [](const auto &traversal) {
+        std::vector<int> values;
+        std::ranges::copy(traversal, std::back_inserter(values));
+        return values;
+    };
+
+    auto pinned = container.ascending();
+    container.addElement(3);
+    container.removeElement(9);
+    CHECK(collect(pinned) == std::vector<int>{2, 4, 5, 9});
+    CHECK(pinned.container().size() == 4);
+    CHECK(container.size() == 4);
+
+    auto side = container.sideCross();
+    CHECK(collect(side) == std::vector<int>{2, 5, 3, 4});
+    auto primes = container.primes();
+    CHECK(collect(primes) == std::vector<int>{2, 3, 5});
+
+    CHECK_THROWS_AS(container.removeElements({2, 100}), runtime_error);
+    CHECK(container.size() == 4);
+
+    container.update([](MagicalContainer &snapshot) {
+        snapshot.addElement(7);
+        snapshot.removeElement(2);
+    });
+    CHECK(*container.ascending().begin() == 3);
+    CHECK(container.snapshot()->size() == 4);
+}
+
+TEST_CASE("ConcurrentMagicalContainer readers run during writes") {
+    ConcurrentMagicalContainer container;
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < 3; ++reader) {
+        readers.emplace_back([&container, &done, &consistent] {
+            while (!done) {
+                auto traversal = container.ascending();
+                std::size_t count = 0;
+                int previous = std::numeric_limits<int>::min();
+                for (int value : traversal) {
+                    if (value < previous) {
+                        consistent = false;
+                    }
+                    previous = value;
+                    ++count;
+                }
+                if (count != traversal.container().size()) {
+                    consistent = false;
+                }
+            }
+        });
+    }
+
+    for (int value = 0; value < 500; ++value) {
+        container.addElement(value);
+        if (value % 5 == 4) {
+            container.removeElement(value - 2);
+        }
+    }
+    done = true;
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+    CHECK(consistent);
+    CHECK(container.size() == 400);
+}
+
+TEST_CASE("ConcurrentMagicalContainer combines writes from several threads") {
+    ConcurrentMagicalContainer container;
+    constexpr int writers = 4;
+    constexpr int per_writer = 500;
+    std::atomic<int> failures{0};
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+
+    std::thread reader([&container, &done, &consistent] {
+        while (!done) {
+            auto snapshot = container.snapshot();
+            if (!std::ranges::is_sorted(snapshot->ascending())) {
+                consistent = false;
+            }
+        }
+    });
+    std::vector<std::thread> threads;
+    for (int writer = 0; writer < writers; ++writer) {
+        threads.emplace_back([&container, &failures, writer] {
+            for (int value = 0; value < per_writer; ++value) {
+                container.addElement(writer * per_writer + value);
+                if (value % 10 == 9) {
+                    container.removeElement(writer * per_writer + value);
+                    try {
+                        container.removeElement(-1 - value);
+                    } catch (const runtime_error &) {
+                        ++failures;
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    done = true;
+    reader.join();
+
+    CHECK(consistent);
+    CHECK(failures == writers * per_writer / 10);
+    CHECK(container.size() == writers * per_writer * 9 / 10);
+    auto traversal = container.ascending();
+    CHECK(std::ranges::adjacent_find(traversal) == traversal.end());
+}
+
+// Test case for the lock-free ingest path
+TEST_CASE("ConcurrentMagicalContainer ingests from producers") {
+    ConcurrentMagicalContainer container;
+    container.addElement(-1);
+
+    constexpr int producers = 4;
+    constexpr int per_producer = 10000;
+    std::vector<std::thread> threads;
+    for (int producer_index = 0; producer_index < producers; ++producer_index) {
+        threads.emplace_back([&container, producer_index] {
+            auto producer = container.producer();
+            for (int value = 0; value < per_producer; ++value) {
+                producer.push(producer_index * per_producer + value);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    container.flush();
+
+    auto traversal = container.ascending();
+    CHECK(traversal.container().size() == producers * per_producer + 1);
+    CHECK(std::ranges::is_sorted(traversal));
+    CHECK(*traversal.begin() == -1);
+
+    auto producer = container.producer();
+    producer.push(123456);
+    container.flush();
+    CHECK(container.size() == producers * per_producer + 2);
+
+    ConcurrentMagicalContainer::Producer unbound;
+    CHECK_THROWS_AS(unbound.push(1), runtime_error);
+}
+
+TEST_CASE("ConcurrentMagicalContainer merges buffered values when it closes") {
+    ConcurrentMagicalContainer::Snapshot last;
+    {
+        ConcurrentMagicalContainer container;
+        std::thread pusher([&container] {
+            auto producer = container.producer();
+            for (int value = 0; value < 5000; ++value) {
+                producer.push(value);
+            }
+        });
+        pusher.join();
+        last = container.close();
+        CHECK(container.size() == 5000);
+    }
+    REQUIRE(last != nullptr);
+    CHECK(last->size() == 5000);
+    CHECK(std::ranges::equal(last->ascending(), std::views::iota(0, 5000)));
+}
+
+// Test case for the iterator invalidation checks
+TEST_CASE("Iterators detect use after modification") {
+    MagicalContainer container;
+    container.addElements({2, 3, 4, 9});
+
+    MagicalContainer::AscendingIterator ascending(container);
+    MagicalContainer::SideCrossIterator cross(container);
+    MagicalContainer::PrimeIterator prime(container);
+    MagicalContainer::AscendingIterator copy = ascending;
+    CHECK(*copy == 2);
+
+    container.addElement(5);
+    if (MAGICAL_CHECKED_ITERATORS) {
+        CHECK_THROWS_AS(*ascending, runtime_error);
+        CHECK_THROWS_AS(++copy, runtime_error);
+        CHECK_THROWS_AS(cross[1], runtime_error);
+        CHECK_THROWS_AS(*prime, runtime_error);
+    } else {
+        CHECK(std::is_empty_v<VersionStamp>);
+    }
+    CHECK(*MagicalContainer::AscendingIterator(container) == 2);
+
+    MagicalContainer::PrimeIterator fresh(container);
+    container.removeElements({4, 9});
+    MagicalContainer other;
+    other.addElement(7);
+    MagicalContainer::AscendingIterator before_assignment(container);
+    container = other;
+    if (MAGICAL_CHECKED_ITERATORS) {
+        CHECK_THROWS_AS(*fresh, runtime_error);
+        CHECK_THROWS_AS(*before_assignment, runtime_error);
+    }
+    CHECK(*container.ascending().begin() == 7);
+}
+
+// Test case for the aggregate operations
+TEST_CASE_TEMPLATE("Aggregates agree with iterator loops", Storage, SortedVectorStorage, BPlusTreeStorage, EliasFanoStorage, RoaringStorage) {
+    BasicMagicalContainer<Storage> container;
+    CHECK(container.sum() == 0);
+    CHECK_THROWS_AS(container.min(), runtime_error);
+    CHECK_THROWS_AS(container.max(), runtime_error);
+
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<int> values(-1000, 1000);
+    std::vector<int> batch(1003);
+    for (int &value : batch) {
+        value = values(generator);
+    }
+    batch.push_back(numeric_limits<int>::max());
+    batch.push_back(numeric_limits<int>::max());
+    container.addElements(std::span<const int>(batch));
+
+    long long expected = 0;
+    std::size_t in_range = 0;
+    std::vector<std::size_t> buckets(4);
+    for (int element : container.ascending()) {
+        expected += element;
+        in_range += (element >= -10 && element < 250) ? 1U : 0U;
+        if (element >= -1000 && element < 1000) {
+            ++buckets[static_cast<std::size_t>((element + 1000) / 500)];
+        }
+    }
+    CHECK(container.sum() == expected);
+    CHECK(container.min() == *std::min_element(batch.begin(), batch.end()));
+    CHECK(container.max() == numeric_limits<int>::max());
+    CHECK(container.countInRange(-10, 250) == in_range);
+    CHECK(container.countInRange(5, 5) == 0);
+    CHECK(container.histogram(-1000, 1000, 4) == buckets);
+    CHECK_THROWS_AS(container.histogram(3, 3, 1), runtime_error);
+    CHECK_THROWS_AS(container.histogram(0, 10, 0), runtime_error);
+}
+
+TEST_CASE("Sum kernels agree with each other") {
+    std::vector<int> values(37);
+    std::iota(values.begin(), values.end(), numeric_limits<int>::max() - 40);
+    values[3] = numeric_limits<int>::min();
+    long long expected = std::accumulate(values.begin(), values.end(), 0LL);
+
+    for (std::size_t length = 0; length <= values.size(); ++length) {
+        std::span<const int> prefix(values.data(), length);
+        long long reference = aggregates::sum(prefix, aggregates::SimdLevel::Scalar);
+        CHECK(aggregates::sum(prefix, aggregates::SimdLevel::Sse41) == reference);
+        CHECK(aggregates::sum(prefix, aggregates::SimdLevel::Avx2) == reference);
+        CHECK(aggregates::sum(prefix) == reference);
+    }
+    CHECK(aggregates::sum(values) == expected);
+}
+
+// Test case for the range queries
+TEST_CASE_TEMPLATE("Range queries use the sorted order", Storage, SortedVectorStorage, BPlusTreeStorage, EliasFanoStorage, RoaringStorage) {
+    BasicMagicalContainer<Storage> container;
+    container.addElements({8, 1, 5, 5, 12, 5, 3});
+
+    CHECK(*container.lowerBound(5) == 5);
+    CHECK(container.lowerBound(5) - container.ascending().begin() == 2);
+    CHECK(*container.upperBound(5) == 8);
+    CHECK(container.upperBound(12) == std::default_sentinel);
+    CHECK(container.lowerBound(13) == std::default_sentinel);
+
+    auto fives = container.equalRange(5);
+    CHECK(std::ranges::distance(fives) == 3);
+    CHECK(std::ranges::all_of(fives, [](int value) { return value == 5; }));
+    CHECK(container.equalRange(4).empty());
+
+    CHECK(container.contains(12));
+    CHECK_FALSE(container.contains(4));
+    CHECK(container.count(5) == 3);
+    CHECK(container.count(7) == 0);
+
+    std::vector<int> window;
+    for (int value : container.ascending(3, 12)) {
+        window.push_back(value);
+    }
+    CHECK(window == std::vector<int>{3, 5, 5, 5, 8});
+    CHECK(container.ascending(10, 2).empty());
+
+    typename BasicMagicalContainer<Storage>::AscendingIterator from_six(container, 6);
+    CHECK(*from_six == 8);
+    ++from_six;
+    CHECK(*from_six == 12);
+}
+
+// Test case for intersection, union and difference
+TEST_CASE_TEMPLATE("Set operations match the standard algorithms", Storage, SortedVectorStorage, BPlusTreeStorage, EliasFanoStorage, RoaringStorage) {
+    std::mt19937 generator(25);
+    std::uniform_int_distribution<int> values(-300, 300);
+    auto draw = [&](std::size_t count) {
+        std::vector<int> drawn(count);
+        for (int &value : drawn) {
+            value = values(generator);
+        }
+        std::sort(drawn.begin(), drawn.end());
+        return drawn;
+    };
+    // Similar sizes merge, skewed sizes gallop; both sides hold repeated values
+    std::vector<int> left = draw(1500);
+    for (std::size_t right_size : {0U, 1U, 17U, 1200U, 5000U}) {
+        std::vector<int> right = draw(right_size);
+        BasicMagicalContainer<Storage> lhs(sorted_range, left);
+        BasicMagicalContainer<Storage> rhs(sorted_range, right);
+
+        std::vector<int> expected;
+        std::set_intersection(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(expected));
+        auto both = lhs.intersect(rhs);
+        CHECK(std::ranges::equal(both.ascending(), expected));
+        CHECK(std::ranges::equal(rhs.intersect(lhs).ascending(), expected));
+        CHECK(std::ranges::equal(both.primes(), BasicMagicalContainer<Storage>(sorted_range, expected).primes()));
+
+        expected.clear();
+        std::set_union(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(expected));
+        CHECK(std::ranges::equal(lhs.unite(rhs).ascending(), expected));
+        CHECK(std::ranges::equal(rhs.unite(lhs).ascending(), expected));
+
+        expected.clear();
+        std::set_difference(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(expected));
+        CHECK(std::ranges::equal(lhs.subtract(rhs).ascending(), expected));
+        expected.clear();
+        std::set_difference(right.begin(), right.end(), left.begin(), left.end(), std::back_inserter(expected));
+        CHECK(std::ranges::equal(rhs.subtract(lhs).ascending(), expected));
+    }
+}
+
+TEST_CASE("Intersection kernels agree with each other") {
+    std::vector<int> evens(1000);
+    std::vector<int> thirds(700);
+    for (std::size_t i = 0; i < evens.size(); ++i) {
+        evens[i] = static_cast<int>(2 * i) - 600;
+    }
+    for (std::size_t i = 0; i < thirds.size(); ++i) {
+        thirds[i] = static_cast<int>(3 * i) - 900;
+    }
+
+    for (std::size_t length : {0U, 7U, 8U, 9U, 63U, 700U}) {
+        std::span<const int> lhs(evens.data(), std::min<std::size_t>(length + 300, evens.size()));
+        std::span<const int> rhs(thirds.data(), length);
+        std::vector<int> expected;
+        std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+        CHECK(setalgebra::intersect(lhs, rhs, aggregates::SimdLevel::Scalar) == expected);
+        CHECK(setalgebra::intersect(lhs, rhs, aggregates::SimdLevel::Avx2) == expected);
+        CHECK(setalgebra::intersect(rhs, lhs, aggregates::SimdLevel::Avx2) == expected);
+    }
+
+    // A repeated value must not be matched twice by the block comparison
+    std::vector<int> repeated = {1, 2, 3, 4, 5, 6, 7, 8, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
+    std::vector<int> single = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30};
+    std::vector<int> expected = {2, 4, 6, 8, 10, 12, 14, 16};
+    CHECK(setalgebra::intersect(std::span<const int>(repeated), std::span<const int>(single), aggregates::SimdLevel::Avx2) == expected);
+    CHECK(setalgebra::intersect(std::span<const int>(single), std::span<const int>(repeated), aggregates::SimdLevel::Avx2) == expected);
+}
+
+// Test case for containers of other element types
+template <typename Container>
+concept HasPrimeTraversal = requires(const Container &container) { container.primes(); };
+
+template <typename Container>
+concept HasHistogram = requires(const Container &container) { container.histogram(0, 1, 1); };
+
+TEST_CASE("MagicalContainer holds other element types") {
+    SUBCASE("64-bit integers keep a prime index") {
+        MagicalContainerOf<std::int64_t> container;
+        const std::int64_t large_prime = 1000000000039LL;
+        container.addElements({large_prime, 4, 3, -7, large_prime + 2, 5000000000LL});
+        CHECK(container.min() == -7);
+        CHECK(container.max() == large_prime + 2);
+        CHECK(container.sum() == large_prime * 2 + 2 + 4 + 3 - 7 + 5000000000LL);
+
+        std::vector<std::int64_t> primes;
+        std::ranges::copy(container.primes(), std::back_inserter(primes));
+        CHECK(primes == std::vector<std::int64_t>{3, large_prime});
+        container.removeElement(large_prime);
+        CHECK(std::ranges::distance(container.primes()) == 1);
+    }
+
+    SUBCASE("Unsigned integers") {
+        MagicalContainerOf<std::uint32_t> container;
+        container.addElements({4294967291U, 1U, 2U, 4294967295U});
+        std::vector<std::uint32_t> primes;
+        std::ranges::copy(container.primes(), std::back_inserter(primes));
+        CHECK(primes == std::vector<std::uint32_t>{2U, 4294967291U});
+        CHECK(container.sum() == 4294967291ULL + 1 + 2 + 4294967295ULL);
+        CHECK(container.histogram(0U, 4294967295U, 2) == std::vector<std::size_t>{2, 1});
+    }
+
+    SUBCASE("Floating point without primes") {
+        MagicalContainerOf<double> container;
+        container.addElements({2.5, -1.0, 7.0, 3.0});
+        CHECK_FALSE(MagicalContainerOf<double>::has_primes);
+        CHECK_FALSE(HasPrimeTraversal<MagicalContainerOf<double>>);
+        CHECK(HasPrimeTraversal<MagicalContainer>);
+        CHECK(container.sum() == doctest::Approx(11.5));
+        CHECK(container.countInRange(0.0, 3.0) == 1);
+        CHECK(container.histogram(-2.0, 8.0, 2) == std::vector<std::size_t>{2, 2});
+
+        std::vector<double> cross;
+        std::ranges::copy(container.sideCross(), std::back_inserter(cross));
+        CHECK(cross == std::vector<double>{-1.0, 7.0, 2.5, 3.0});
+        CHECK_THROWS_AS(container.parallelForEach(TraversalOrder::Prime, [](double) {}), runtime_error);
+    }
+
+    SUBCASE("Descending order") {
+        MagicalContainerOf<int, std::greater<int>> container;
+        container.addElements({3, 9, -4, 7});
+        CHECK(std::ranges::equal(container.ascending(), std::vector<int>{9, 7, 3, -4}));
+        CHECK(container.countInRange(9, 3) == 2);
+        CHECK(container.sum() == 15);
+        CHECK(container.min() == 9);
+        CHECK(container.max() == -4);
+        CHECK_FALSE(HasHistogram<MagicalContainerOf<int, std::greater<int>>>);
+        CHECK(HasHistogram<MagicalContainer>);
+    }
+
+    SUBCASE("Structs ordered by a key") {
+        struct Event {
+            std::int64_t timestamp;
+            int payload;
+        };
+        struct ByTimestamp {
+            bool operator()(const Event &lhs, const Event &rhs) const {
+                return lhs.timestamp < rhs.timestamp;
+            }
+        };
+        MagicalContainerOf<Event, ByTimestamp> container;
+        container.addElements({{30, 1}, {10, 2}, {20, 3}});
+        container.addElement({15, 4});
+        CHECK(container.contains({20, 0}));
+        CHECK(container.lowerBound({12, 0})->payload == 4);
+
+        std::vector<int> payloads;
+        for (const Event &event : container.ascending()) {
+            payloads.push_back(event.payload);
+        }
+        CHECK(payloads == std::vector<int>{2, 4, 3, 1});
+        container.removeElements({{10, 0}, {30, 0}});
+        CHECK(container.size() == 2);
+        CHECK_THROWS_AS(container.removeElement({99, 0}), runtime_error);
+    }
+}
+
+TEST_CASE("Wide primality agrees on known values") {
+    CHECK(primality::isPrimeWide(2));
+    CHECK(primality::isPrimeWide(4294967291ULL));
+    CHECK_FALSE(primality::isPrimeWide(4294967297ULL));
+    CHECK(primality::isPrimeWide(1000000000039ULL));
+    CHECK(primality::isPrimeWide(18446744073709551557ULL));
+    CHECK_FALSE(primality::isPrimeWide(18446744073709551615ULL));
+    CHECK_FALSE(primality::isPrimeWide(3825123056546413051ULL));
+}
+
+// Test case for snapshot files
+TEST_CASE_TEMPLATE("Snapshots round-trip the elements and the prime index", Storage, SortedVectorStorage, BPlusTreeStorage, EliasFanoStorage, RoaringStorage) {
+    std::string path = (std::filesystem::temp_directory_path() / "magical_snapshot_test.bin").string();
+    BasicMagicalContainer<Storage> container;
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), -100);
+    container.addElements(std::span<const int>(values));
+    container.addElement(7);
+    container.save(path);
+
+    auto loaded = BasicMagicalContainer<Storage>::load(path);
+    CHECK(loaded.size() == container.size());
+    CHECK(std::ranges::equal(loaded.ascending(), container.ascending()));
+    CHECK(std::ranges::equal(loaded.primes(), container.primes()));
+
+    BasicMagicalContainer<Storage> empty;
+    empty.save(path);
+    CHECK(BasicMagicalContainer<Storage>::load(path).size() == 0);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Snapshots reject foreign and corrupted files") {
+    std::string path = (std::filesystem::temp_directory_path() / "magical_snapshot_corrupt.bin").string();
+    MagicalContainer container;
+    container.addElements({1, 2, 3, 5, 8, 13});
+    container.save(path);
+
+    CHECK_THROWS_AS(MagicalContainerOf<std::int64_t>::load(path), runtime_error);
+    CHECK_THROWS_AS(MagicalContainerOf<float>::load(path), runtime_error);
+
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(snapshot::alignment + 4));
+        file.put('\x7f');
+    }
+    CHECK_THROWS_AS(MagicalContainer::load(path), runtime_error);
+
+    std::filesystem::resize_file(path, 70);
+    CHECK_THROWS_AS(MagicalContainer::load(path), runtime_error);
+    std::filesystem::remove(path);
+    CHECK_THROWS_AS(MagicalContainer::load(path), runtime_error);
+
+    MagicalContainerOf<double> decimals;
+    decimals.addElements({0.5, -2.25});
+    decimals.save(path);
+    auto loaded = MagicalContainerOf<double>::load(path);
+    CHECK(loaded.min() == -2.25);
+    CHECK(loaded.max() == 0.5);
+
+    // Same size, other signedness: 2^31 + 1 would load as a negative int after 3
+    MagicalContainerOf<std::uint32_t> unsigned_values;
+    unsigned_values.addElements({1U, 3U, 2147483649U});
+    unsigned_values.save(path);
+    CHECK_THROWS_AS(MagicalContainer::load(path), runtime_error);
+    CHECK_THROWS_AS(MappedMagicalContainer<>::load(path), runtime_error);
+    CHECK(MagicalContainerOf<std::uint32_t>::load(path).size() == 3);
+
+    // Same type, other ordering
+    container.save(path);
+    CHECK_THROWS_AS((MagicalContainerOf<int, std::greater<int>>::load(path)), runtime_error);
+    CHECK_THROWS_AS((MappedMagicalContainer<int, std::greater<int>>::load(path)), runtime_error);
+    MagicalContainerOf<int, std::greater<int>> descending;
+    descending.addElements({1, 3, 5});
+    descending.save(path);
+    CHECK_THROWS_AS(MagicalContainer::load(path), runtime_error);
+    CHECK((MagicalContainerOf<int, std::greater<int>>::load(path).contains(3)));
+
+    // An offset that wraps the bounds check around must not reach the element pointers
+    container.save(path);
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        std::uint64_t offset = 0xFFFFFFFFFFFFFFC0;
+        std::uint64_t count = 16;
+        file.seekp(static_cast<std::streamoff>(offsetof(snapshot::Header, elements_offset)));
+        file.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+        file.seekp(static_cast<std::streamoff>(offsetof(snapshot::Header, element_count)));
+        file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    }
+    CHECK_THROWS_AS(MagicalContainer::load(path), runtime_error);
+    CHECK_THROWS_AS(MappedMagicalContainer<>::load(path), runtime_error);
+    std::filesystem::remove(path);
+}
+
+// Test case for the memory-mapped container
+TEST_CASE("Mapped containers traverse a snapshot in place") {
+    std::string path = (std::filesystem::temp_directory_path() / "magical_snapshot_mapped.bin").string();
+    MagicalContainer container;
+    std::vector<int> values(5000);
+    std::iota(values.begin(), values.end(), -2000);
+    container.addElements(std::span<const int>(values));
+    container.save(path);
+
+    MappedMagicalContainer<> mapped = MappedMagicalContainer<>::load(path);
+    CHECK(mapped.size() == container.size());
+    CHECK(std::ranges::equal(mapped.ascending(), container.ascending()));
+    CHECK(std::ranges::equal(mapped.sideCross(), container.sideCross()));
+    CHECK(std::ranges::equal(mapped.primes(), container.primes()));
+    CHECK(std::ranges::equal(mapped.ascending(10, 20), container.ascending(10, 20)));
+    CHECK(mapped.contains(2999));
+    CHECK_FALSE(mapped.contains(3000));
+    CHECK(mapped.sum() == container.sum());
+    CHECK(mapped.countInRange(-5, 5) == container.countInRange(-5, 5));
+
+    // Saving over the mapped file replaces it by rename, so the mapping keeps the old contents
+    MagicalContainer replacement;
+    replacement.addElements({1, 2, 3});
+    replacement.save(path);
+    CHECK(std::ranges::equal(mapped.ascending(), container.ascending()));
+    CHECK(MappedMagicalContainer<>::load(path).size() == 3);
+    CHECK_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    // A bare file name syncs the current directory; a missing directory fails before any rename
+    replacement.save("magical_snapshot_relative.bin");
+    CHECK(MagicalContainer::load("magical_snapshot_relative.bin").size() == 3);
+    std::filesystem::remove("magical_snapshot_relative.bin");
+    CHECK_THROWS_AS(replacement.save((std::filesystem::temp_directory_path() / "magical_missing" / "snapshot.bin").string()), runtime_error);
+
+    // Copies share the mapping, which outlives the original and the file name
+    auto copy = mapped;
+    mapped = MappedMagicalContainer<>();
+    std::filesystem::remove(path);
+    CHECK(mapped.size() == 0);
+    CHECK(std::ranges::equal(copy.ascending(), container.ascending()));
+
+    MagicalContainerOf<double> decimals;
+    decimals.addElements({0.5, -2.25, 4.0});
+    decimals.save(path);
+    CHECK_THROWS_AS(MappedMagicalContainer<>::load(path), runtime_error);
+    auto mapped_decimals = MappedMagicalContainer<double>::load(path);
+    CHECK(std::ranges::equal(mapped_decimals.sideCross(), decimals.sideCross()));
+    std::filesystem::remove(path);
+    CHECK_THROWS_AS(MappedMagicalContainer<>::load(path), runtime_error);
+}
@@ -0,0 +1,120 @@
+#include "Aggregates.hpp"
+#include <algorithm>
+#include <cstddef>
+#include "SimdTarget.hpp"
+
+using namespace ariel;
+
+namespace
+{
+    /**
+     * @brief Adds values one at a time.
+     * @param values The values to add.
+     * @return The sum.
+     */
+    std::int64_t sumScalar(std::span<const int> values)
+    {
+        std::int64_t total = 0;
+        for (int value : values)
+        {
+            total += value;
+        }
+        return total;
+    }
+
+#if MAGICAL_X86_KERNELS
+    /**
+     * @brief Adds values four at a time, widening them to 64 bits with SSE4.1.
+     * @param values The values to add.
+     * @return The sum.
+     */
+    __attribute__((target("sse4.1"))) std::int64_t sumSse41(std::span<const int> values)
+    {
+        const int *data = values.data();
+        std::size_t size = values.size();
+        __m128i low = _mm_setzero_si128();
+        __m128i high = _mm_setzero_si128();
+
+        std::size_t i = 0;
+        for (; i + 4 <= size; i += 4)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            low = _mm_add_epi64(low, _mm_cvtepi32_epi64(block));
+            high = _mm_add_epi64(high, _mm_cvtepi32_epi64(_mm_srli_si128(block, 8)));
+        }
+
+        __m128i lanes = _mm_add_epi64(low, high);
+        std::int64_t total = _mm_extract_epi64(lanes, 0) + _mm_extract_epi64(lanes, 1);
+        return total + sumScalar(values.subspan(i));
+    }
+
+    /**
+     * @brief Adds values eight at a time, widening them to 64 bits with AVX2.
+     * @param values The values to add.
+     * @return The sum.
+     */
+    __attribute__((target("avx2"))) std::int64_t sumAvx2(std::span<const int> values)
+    {
+        const int *data = values.data();
+        std::size_t size = values.size();
+        __m256i low = _mm256_setzero_si256();
+        __m256i high = _mm256_setzero_si256();
+
+        std::size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            low = _mm256_add_epi64(low, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(block)));
+            high = _mm256_add_epi64(high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(block, 1)));
+        }
+
+        __m256i lanes = _mm256_add_epi64(low, high);
+        __m128i pair = _mm_add_epi64(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+        std::int64_t total = _mm_extract_epi64(pair, 0) + _mm_extract_epi64(pair, 1);
+        return total + sumScalar(values.subspan(i));
+    }
+#endif
+} // namespace
+
+aggregates::SimdLevel aggregates::detectedLevel()
+{
+#if MAGICAL_X86_KERNELS
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return SimdLevel::Avx2;
+        }
+        if (__builtin_cpu_supports("sse4.1"))
+        {
+            return SimdLevel::Sse41;
+        }
+        return SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+std::int64_t aggregates::sum(std::span<const int> values)
+{
+    return sum(values, detectedLevel());
+}
+
+std::int64_t aggregates::sum(std::span<const int> values, SimdLevel level)
+{
+    level = std::min(level, detectedLevel());
+#if MAGICAL_X86_KERNELS
+    switch (level)
+    {
+    case SimdLevel::Avx2:
+        return sumAvx2(values);
+    case SimdLevel::Sse41:
+        return sumSse41(values);
+    case SimdLevel::Scalar:
+        break;
+    }
+#endif
+    return sumScalar(values);
+}
@@ -0,0 +1,46 @@
+#ifndef CPP_EX4_PARTA_AGGREGATES_HPP
+#define CPP_EX4_PARTA_AGGREGATES_HPP
+
+#include <cstdint>
+#include <span>
+
+namespace ariel
+{
+    namespace aggregates
+    {
+        /**
+         * @brief The instruction sets the aggregate kernels are written for, from slowest to fastest.
+         */
+        enum class SimdLevel
+        {
+            Scalar,
+            Sse41,
+            Avx2
+        };
+
+        /**
+         * @brief Returns the fastest kernel level the running CPU supports.
+         * @return The level, detected once and cached. Always Scalar on targets other than x86-64.
+         */
+        SimdLevel detectedLevel();
+
+        /**
+         * @brief Sums values with the fastest kernel the running CPU supports.
+         * @param values The values to add.
+         * @return The sum, accumulated in 64 bits so it cannot overflow for any int input.
+         */
+        std::int64_t sum(std::span<const int> values);
+
+        /**
+         * @brief Sums values with a given kernel.
+         * @param values The values to add.
+         * @param level The kernel to use. Levels the CPU does not support fall back to detectedLevel().
+         * @return The sum, accumulated in 64 bits.
+         *
+         * Exposed so tests and benchmarks can compare the kernels with each other.
+         */
+        std::int64_t sum(std::span<const int> values, SimdLevel level);
+    } // namespace aggregates
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_AGGREGATES_HPP
@@ -0,0 +1,490 @@
+#include "BPlusTreeStorage.hpp"
+#include <algorithm>
+#include <iterator>
+using namespace ariel;
+
+/**
+ * @struct BPlusTreeStorage::Node
+ * @brief A node of the tree: a leaf holding sorted elements, or an inner node holding subtrees.
+ *
+ * In an inner node keys[i] is a lower bound of child i and an upper bound of child i - 1
+ * (keys[0] is kept only so the vectors stay aligned). The bounds stay valid when elements are
+ * removed, so removals never have to walk back up the tree to fix them.
+ */
+struct BPlusTreeStorage::Node
+{
+    bool is_leaf = true;                          /**< True for leaves, false for inner nodes. */
+    std::size_t count = 0;                        /**< Number of elements stored under this node. */
+    std::vector<int> keys;                        /**< Leaf: the elements. Inner: the child bounds. */
+    std::vector<std::size_t> counts;              /**< Inner: number of elements under each child. */
+    std::vector<std::unique_ptr<Node>> children;  /**< Inner: the subtrees. */
+};
+
+/**
+ * @brief Constructs an empty tree.
+ */
+BPlusTreeStorage::BPlusTreeStorage() = default;
+
+/**
+ * @brief Constructs the tree bottom-up from a vector that is already sorted.
+ * @param sorted_elements The elements, in ascending order.
+ */
+BPlusTreeStorage::BPlusTreeStorage(std::vector<int> sorted_elements)
+{
+    build(sorted_elements);
+}
+
+/**
+ * @brief Copy constructor, rebuilds a compact copy of the other tree.
+ * @param other The tree to copy.
+ */
+BPlusTreeStorage::BPlusTreeStorage(const BPlusTreeStorage &other)
+{
+    build(other.toVector());
+}
+
+/**
+ * @brief Move constructor. The other tree is left empty.
+ * @param other The tree to move from.
+ */
+BPlusTreeStorage::BPlusTreeStorage(BPlusTreeStorage &&other) noexcept = default;
+
+/**
+ * @brief Copy assignment operator.
+ * @param other The tree to copy.
+ * @return Reference to this tree.
+ */
+BPlusTreeStorage &BPlusTreeStorage::operator=(const BPlusTreeStorage &other)
+{
+    if (this != &other)
+    {
+        build(other.toVector());
+    }
+    return *this;
+}
+
+/**
+ * @brief Move assignment operator. The other tree is left empty.
+ * @param other The tree to move from.
+ * @return Reference to this tree.
+ */
+BPlusTreeStorage &BPlusTreeStorage::operator=(BPlusTreeStorage &&other) noexcept = default;
+
+/**
+ * @brief Destructor.
+ */
+BPlusTreeStorage::~BPlusTreeStorage() = default;
+
+/**
+ * @brief Returns the number of stored elements.
+ * @return The number of elements.
+ */
+std::size_t BPlusTreeStorage::size() const
+{
+    return root ? root->count : 0;
+}
+
+/**
+ * @brief Returns the element with the given rank.
+ * @param index The rank of the element (0 is the smallest). Must be less than size().
+ * @return The element at that rank.
+ */
+const int &BPlusTreeStorage::operator[](std::size_t index) const
+{
+    const Node *node = root.get();
+    while (!node->is_leaf)
+    {
+        std::size_t child = 0;
+        while (index >= node->counts[child])
+        {
+            index -= node->counts[child];
+            ++child;
+        }
+        node = node->children[child].get();
+    }
+    return node->keys[index];
+}
+
+/**
+ * @brief Returns the rank of the first element not less than value.
+ * @param value The value to look for.
+ * @return The rank, or size() if every element is less than value.
+ */
+std::size_t BPlusTreeStorage::lowerBound(int value) const
+{
+    if (!root)
+    {
+        return 0;
+    }
+
+    std::size_t rank = 0;
+    const Node *node = root.get();
+    while (!node->is_leaf)
+    {
+        // Every child before the last one bounded below by a key < value only holds smaller elements
+        auto child = static_cast<std::size_t>(std::lower_bound(node->keys.begin() + 1, node->keys.end(), value) - node->keys.begin()) - 1;
+        for (std::size_t i = 0; i < child; ++i)
+        {
+            rank += node->counts[i];
+        }
+        node = node->children[child].get();
+    }
+    return rank + static_cast<std::size_t>(std::lower_bound(node->keys.begin(), node->keys.end(), value) - node->keys.begin());
+}
+
+/**
+ * @brief Returns the rank of the first element greater than value.
+ * @param value The value to look for.
+ * @return The rank, or size() if no element is greater than value.
+ */
+std::size_t BPlusTreeStorage::upperBound(int value) const
+{
+    if (!root)
+    {
+        return 0;
+    }
+
+    std::size_t rank = 0;
+    const Node *node = root.get();
+    while (!node->is_leaf)
+    {
+        auto child = static_cast<std::size_t>(std::upper_bound(node->keys.begin() + 1, node->keys.end(), value) - node->keys.begin()) - 1;
+        for (std::size_t i = 0; i < child; ++i)
+        {
+            rank += node->counts[i];
+        }
+        node = node->children[child].get();
+    }
+    return rank + static_cast<std::size_t>(std::upper_bound(node->keys.begin(), node->keys.end(), value) - node->keys.begin());
+}
+
+/**
+ * @brief Inserts a value, keeping the elements sorted.
+ * @param value The value to insert.
+ */
+void BPlusTreeStorage::insert(int value)
+{
+    if (!root)
+    {
+        root = std::make_unique<Node>();
+    }
+
+    std::unique_ptr<Node> split = insertInto(*root, value);
+    if (split)
+    {
+        auto new_root = std::make_unique<Node>();
+        new_root->is_leaf = false;
+        new_root->count = root->count + split->count;
+        new_root->keys = {root->keys.front(), split->keys.front()};
+        new_root->counts = {root->count, split->count};
+        new_root->children.push_back(std::move(root));
+        new_root->children.push_back(std::move(split));
+        root = std::move(new_root);
+    }
+}
+
+/**
+ * @brief Merges an already sorted batch of values into the tree.
+ * @param sorted_values The values to insert, in ascending order.
+ *
+ * Small batches are inserted one by one; large ones rebuild the tree from the merged sequence.
+ */
+void BPlusTreeStorage::insertSorted(std::span<const int> sorted_values)
+{
+    if (sorted_values.size() * 8 < size())
+    {
+        for (int value : sorted_values)
+        {
+            insert(value);
+        }
+        return;
+    }
+
+    std::vector<int> current = toVector();
+    std::vector<int> merged;
+    merged.reserve(current.size() + sorted_values.size());
+    std::merge(current.begin(), current.end(), sorted_values.begin(), sorted_values.end(), std::back_inserter(merged));
+    build(merged);
+}
+
+/**
+ * @brief Removes a single occurrence of a value.
+ * @param value The value to remove.
+ * @return True if the value was found and removed, false otherwise.
+ */
+bool BPlusTreeStorage::erase(int value)
+{
+    std::size_t rank = lowerBound(value);
+    if (rank == size() || (*this)[rank] != value)
+    {
+        return false;
+    }
+
+    eraseAt(*root, rank);
+    while (!root->is_leaf && root->children.size() == 1)
+    {
+        root = std::move(root->children.front());
+    }
+    if (root->count == 0)
+    {
+        root.reset();
+    }
+    return true;
+}
+
+/**
+ * @brief Removes one occurrence of every value of a sorted batch.
+ * @param sorted_values The values to remove, in ascending order. All of them must be stored.
+ *
+ * Small batches are removed one by one; large ones rebuild the tree from the sorted difference.
+ */
+void BPlusTreeStorage::eraseSorted(std::span<const int> sorted_values)
+{
+    if (sorted_values.size() * 8 < size())
+    {
+        for (int value : sorted_values)
+        {
+            erase(value);
+        }
+        return;
+    }
+
+    std::vector<int> current = toVector();
+    std::vector<int> remaining;
+    remaining.reserve(current.size() - sorted_values.size());
+    std::set_difference(current.begin(), current.end(), sorted_values.begin(), sorted_values.end(), std::back_inserter(remaining));
+    build(remaining);
+}
+
+/**
+ * @brief Inserts a value into the subtree rooted at node.
+ * @param node The root of the subtree.
+ * @param value The value to insert.
+ * @return The new right sibling if node had to be split, nullptr otherwise.
+ */
+std::unique_ptr<BPlusTreeStorage::Node> BPlusTreeStorage::insertInto(Node &node, int value)
+{
+    ++node.count;
+    if (node.is_leaf)
+    {
+        node.keys.insert(std::upper_bound(node.keys.begin(), node.keys.end(), value), value);
+        if (node.keys.size() <= leaf_capacity)
+        {
+            return nullptr;
+        }
+
+        auto right = std::make_unique<Node>();
+        auto half = node.keys.begin() + static_cast<std::ptrdiff_t>(node.keys.size() / 2);
+        right->keys.assign(half, node.keys.end());
+        node.keys.erase(half, node.keys.end());
+        right->count = right->keys.size();
+        node.count = node.keys.size();
+        return right;
+    }
+
+    auto child = static_cast<std::size_t>(std::upper_bound(node.keys.begin() + 1, node.keys.end(), value) - node.keys.begin()) - 1;
+    std::unique_ptr<Node> split = insertInto(*node.children[child], value);
+    ++node.counts[child];
+    if (!split)
+    {
+        return nullptr;
+    }
+
+    auto position = static_cast<std::ptrdiff_t>(child + 1);
+    node.counts[child] = node.children[child]->count;
+    node.keys.insert(node.keys.begin() + position, split->keys.front());
+    node.counts.insert(node.counts.begin() + position, split->count);
+    node.children.insert(node.children.begin() + position, std::move(split));
+    if (node.children.size() <= inner_capacity)
+    {
+        return nullptr;
+    }
+
+    auto right = std::make_unique<Node>();
+    auto half = static_cast<std::ptrdiff_t>(node.children.size() / 2);
+    right->is_leaf = false;
+    right->keys.assign(node.keys.begin() + half, node.keys.end());
+    right->counts.assign(node.counts.begin() + half, node.counts.end());
+    right->children.assign(std::make_move_iterator(node.children.begin() + half), std::make_move_iterator(node.children.end()));
+    node.keys.erase(node.keys.begin() + half, node.keys.end());
+    node.counts.erase(node.counts.begin() + half, node.counts.end());
+    node.children.erase(node.children.begin() + half, node.children.end());
+    for (std::size_t count : right->counts)
+    {
+        right->count += count;
+    }
+    node.count -= right->count;
+    return right;
+}
+
+/**
+ * @brief Removes the element with the given rank from the subtree rooted at node.
+ * @param node The root of the subtree.
+ * @param rank The rank of the element inside the subtree.
+ *
+ * Children that become empty are unlinked, and children that become small are merged with a neighbour.
+ */
+void BPlusTreeStorage::eraseAt(Node &node, std::size_t rank)
+{
+    --node.count;
+    if (node.is_leaf)
+    {
+        node.keys.erase(node.keys.begin() + static_cast<std::ptrdiff_t>(rank));
+        return;
+    }
+
+    std::size_t child = 0;
+    while (rank >= node.counts[child])
+    {
+        rank -= node.counts[child];
+        ++child;
+    }
+    eraseAt(*node.children[child], rank);
+    --node.counts[child];
+
+    if (node.counts[child] == 0)
+    {
+        auto position = static_cast<std::ptrdiff_t>(child);
+        node.keys.erase(node.keys.begin() + position);
+        node.counts.erase(node.counts.begin() + position);
+        node.children.erase(node.children.begin() + position);
+        return;
+    }
+    mergeChildren(node, child);
+}
+
+/**
+ * @brief Merges the child at index with a neighbour if both fit in half a node.
+ * @param node The inner node owning the children.
+ * @param index The child that just shrank.
+ */
+void BPlusTreeStorage::mergeChildren(Node &node, std::size_t index)
+{
+    auto fits = [&node](std::size_t left) {
+        const Node &first = *node.children[left];
+        const Node &second = *node.children[left + 1];
+        if (first.is_leaf)
+        {
+            return first.keys.size() + second.keys.size() <= leaf_capacity / 2;
+        }
+        return first.children.size() + second.children.size() <= inner_capacity / 2;
+    };
+
+    std::size_t left = 0;
+    if (index + 1 < node.children.size() && fits(index))
+    {
+        left = index;
+    }
+    else if (index > 0 && fits(index - 1))
+    {
+        left = index - 1;
+    }
+    else
+    {
+        return;
+    }
+
+    Node &first = *node.children[left];
+    Node &second = *node.children[left + 1];
+    if (first.is_leaf)
+    {
+        first.keys.insert(first.keys.end(), second.keys.begin(), second.keys.end());
+    }
+    else
+    {
+        first.keys.push_back(node.keys[left + 1]);
+        first.keys.insert(first.keys.end(), second.keys.begin() + 1, second.keys.end());
+        first.counts.insert(first.counts.end(), second.counts.begin(), second.counts.end());
+        first.children.insert(first.children.end(), std::make_move_iterator(second.children.begin()), std::make_move_iterator(second.children.end()));
+    }
+    first.count += second.count;
+    node.counts[left] = first.count;
+
+    auto position = static_cast<std::ptrdiff_t>(left + 1);
+    node.keys.erase(node.keys.begin() + position);
+    node.counts.erase(node.counts.begin() + position);
+    node.children.erase(node.children.begin() + position);
+}
+
+/**
+ * @brief Replaces the content of the tree, building it bottom-up from sorted elements.
+ * @param sorted_elements The elements, in ascending order.
+ *
+ * Nodes are filled to three quarters so that the next insertions do not split them right away.
+ */
+void BPlusTreeStorage::build(const std::vector<int> &sorted_elements)
+{
+    std::vector<std::unique_ptr<Node>> level;
+    const std::size_t leaf_fill = leaf_capacity * 3 / 4;
+    for (std::size_t start = 0; start < sorted_elements.size(); start += leaf_fill)
+    {
+        std::size_t stop = std::min(start + leaf_fill, sorted_elements.size());
+        auto leaf = std::make_unique<Node>();
+        leaf->keys.assign(sorted_elements.begin() + static_cast<std::ptrdiff_t>(start), sorted_elements.begin() + static_cast<std::ptrdiff_t>(stop));
+        leaf->count = stop - start;
+        level.push_back(std::move(leaf));
+    }
+
+    const std::size_t inner_fill = inner_capacity * 3 / 4;
+    while (level.size() > 1)
+    {
+        std::vector<std::unique_ptr<Node>> parents;
+        for (std::size_t start = 0; start < level.size(); start += inner_fill)
+        {
+            std::size_t stop = std::min(start + inner_fill, level.size());
+            auto parent = std::make_unique<Node>();
+            parent->is_leaf = false;
+            for (std::size_t i = start; i < stop; ++i)
+            {
+                parent->keys.push_back(level[i]->keys.front());
+                parent->counts.push_back(level[i]->count);
+                parent->count += level[i]->count;
+                parent->children.push_back(std::move(level[i]));
+            }
+            parents.push_back(std::move(parent));
+        }
+        level = std::move(parents);
+    }
+
+    if (level.empty())
+    {
+        root.reset();
+    }
+    else
+    {
+        root = std::move(level.front());
+    }
+}
+
+/**
+ * @brief Collects every element of the tree in ascending order.
+ * @return The sorted elements.
+ */
+std::vector<int> BPlusTreeStorage::toVector() const
+{
+    std::vector<int> result;
+    if (!root)
+    {
+        return result;
+    }
+
+    result.reserve(root->count);
+    std::vector<const Node *> pending = {root.get()};
+    while (!pending.empty())
+    {
+        const Node *node = pending.back();
+        pending.pop_back();
+        if (node->is_leaf)
+        {
+            result.insert(result.end(), node->keys.begin(), node->keys.end());
+        }
+        else
+        {
+            for (auto child = node->children.rbegin(); child != node->children.rend(); ++child)
+            {
+                pending.push_back(child->get());
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,67 @@
+#ifndef CPP_EX4_PARTA_BPLUSTREESTORAGE_HPP
+#define CPP_EX4_PARTA_BPLUSTREESTORAGE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace ariel
+{
+    /**
+     * @class BPlusTreeStorage
+     * @brief Storage policy keeping the elements of a MagicalContainer in an order-statistic B+tree.
+     *
+     * Elements are kept in wide, sorted leaves and every inner node records how many elements
+     * each of its subtrees holds. Insertions and removals only touch one root-to-leaf path, so
+     * they cost O(log N) instead of the O(N) shift of a sorted vector, and the element with a
+     * given rank (which is what the iterators ask for) is found in O(log N) as well.
+     * This is the backend to pick for write-heavy workloads.
+     */
+    class BPlusTreeStorage
+    {
+    private:
+        struct Node;
+
+        static constexpr std::size_t leaf_capacity = 128; /**< Maximum number of elements in a leaf. */
+        static constexpr std::size_t inner_capacity = 64; /**< Maximum number of children of an inner node. */
+
+        std::unique_ptr<Node> root; /**< The root of the tree, a leaf while the tree is small. */
+
+        static std::unique_ptr<Node> insertInto(Node &node, int value);
+        static void eraseAt(Node &node, std::size_t rank);
+        static void mergeChildren(Node &node, std::size_t index);
+        void build(const std::vector<int> &sorted_elements);
+        std::vector<int> toVector() const;
+
+    public:
+        using value_type = int;
+        using value_compare = std::less<int>;
+        using const_reference = const int &;
+
+        /**
+         * @brief False, elements are spread over the leaves of the tree.
+         */
+        static constexpr bool is_contiguous = false;
+
+        BPlusTreeStorage();
+        explicit BPlusTreeStorage(std::vector<int> sorted_elements);
+        BPlusTreeStorage(const BPlusTreeStorage &other);
+        BPlusTreeStorage(BPlusTreeStorage &&other) noexcept;
+        BPlusTreeStorage &operator=(const BPlusTreeStorage &other);
+        BPlusTreeStorage &operator=(BPlusTreeStorage &&other) noexcept;
+        ~BPlusTreeStorage();
+
+        std::size_t size() const;
+        const int &operator[](std::size_t index) const;
+        std::size_t lowerBound(int value) const;
+        std::size_t upperBound(int value) const;
+        void insert(int value);
+        void insertSorted(std::span<const int> sorted_values);
+        bool erase(int value);
+        void eraseSorted(std::span<const int> sorted_values);
+    };
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_BPLUSTREESTORAGE_HPP
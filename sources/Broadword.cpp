@@ -0,0 +1,32 @@
+#include "Broadword.hpp"
+using namespace ariel;
+
+namespace
+{
+    /**
+     * @brief Builds broadword::select_in_byte.
+     * @return The position of the k-th set bit of byte b at index b + 256 * k, 8 where b has no k-th bit.
+     */
+    constexpr std::array<std::uint8_t, 256 * 8> selectInByteTable()
+    {
+        std::array<std::uint8_t, 256 * 8> table{};
+        for (unsigned byte = 0; byte < 256; ++byte)
+        {
+            for (unsigned rank = 0; rank < 8; ++rank)
+            {
+                table[byte + 256 * rank] = 8;
+            }
+            unsigned rank = 0;
+            for (unsigned bit = 0; bit < 8; ++bit)
+            {
+                if ((byte >> bit & 1U) != 0)
+                {
+                    table[byte + 256 * rank++] = static_cast<std::uint8_t>(bit);
+                }
+            }
+        }
+        return table;
+    }
+} // namespace
+
+const std::array<std::uint8_t, 256 * 8> broadword::select_in_byte = selectInByteTable();
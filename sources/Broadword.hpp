@@ -0,0 +1,68 @@
+#ifndef CPP_EX4_PARTA_BROADWORD_HPP
+#define CPP_EX4_PARTA_BROADWORD_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace ariel
+{
+    /**
+     * @brief Rank and select inside 64-bit words with plain integer arithmetic.
+     *
+     * The build targets no particular CPU, so std::popcount compiles to a library call; these
+     * helpers stay inline and branch-free instead.
+     */
+    namespace broadword
+    {
+        constexpr std::uint64_t byte_ones = 0x0101010101010101;  /**< A one in every byte. */
+        constexpr std::uint64_t byte_highs = 0x8080808080808080; /**< The top bit of every byte. */
+
+        /**
+         * @brief Position of the k-th set bit of byte b at index b + 256 * k, 8 where b has no k-th bit.
+         */
+        extern const std::array<std::uint8_t, 256 * 8> select_in_byte;
+
+        /**
+         * @brief Counts the set bits of a word, byte by byte.
+         * @param bits The word.
+         * @return A word whose byte i is the number of set bits in bytes 0 .. i of bits; the top byte is the total.
+         */
+        inline std::uint64_t prefixCounts(std::uint64_t bits)
+        {
+            bits = bits - ((bits >> 1) & 0x5555555555555555);
+            bits = (bits & 0x3333333333333333) + ((bits >> 2) & 0x3333333333333333);
+            bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0F;
+            return bits * byte_ones;
+        }
+
+        /**
+         * @brief Counts the set bits of a word.
+         * @param bits The word.
+         * @return The number of set bits.
+         */
+        inline unsigned ones(std::uint64_t bits)
+        {
+            return static_cast<unsigned>(prefixCounts(bits) >> 56);
+        }
+
+        /**
+         * @brief Returns the position of the rank-th set bit of a word.
+         * @param bits The word.
+         * @param counts prefixCounts(bits).
+         * @param rank The rank of the bit, below the number of set bits of the word.
+         * @return The bit position.
+         *
+         * The byte holding the bit is the number of bytes whose prefix count is at most rank,
+         * found for all eight bytes at once; a table gives the position inside that byte.
+         */
+        inline unsigned selectInWord(std::uint64_t bits, std::uint64_t counts, unsigned rank)
+        {
+            std::uint64_t before = ((rank * byte_ones | byte_highs) - counts) & byte_highs;
+            auto shift = static_cast<unsigned>(((before >> 7) * byte_ones) >> 56) * 8;
+            auto in_byte = rank - static_cast<unsigned>(((counts << 8) >> shift) & 0xFF);
+            return shift + select_in_byte[((bits >> shift) & 0xFF) + 256 * in_byte];
+        }
+    } // namespace broadword
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_BROADWORD_HPP
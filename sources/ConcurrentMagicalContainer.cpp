@@ -0,0 +1,390 @@
+#include "ConcurrentMagicalContainer.hpp"
+#include <algorithm>
+using namespace ariel;
+
+/**
+ * @brief Constructs an empty concurrent container.
+ */
+template <typename Storage>
+BasicConcurrentMagicalContainer<Storage>::BasicConcurrentMagicalContainer() : current(new Snapshot(std::make_shared<const Container>())) {}
+
+/**
+ * @brief Stops the background merger after merging the values still buffered by producers.
+ *
+ * Nothing pushed before the destructor runs is dropped: it goes through the same final merge
+ * as close(). Call close() first to keep the resulting snapshot.
+ */
+template <typename Storage>
+BasicConcurrentMagicalContainer<Storage>::~BasicConcurrentMagicalContainer()
+{
+    close();
+    delete current.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Creates a producer handle with its own ingest buffer, starting the merger if needed.
+ * @return The producer.
+ */
+template <typename Storage>
+typename BasicConcurrentMagicalContainer<Storage>::Producer BasicConcurrentMagicalContainer<Storage>::producer()
+{
+    auto ring = std::make_shared<IngestRing>();
+    std::lock_guard<std::mutex> lock(merge_mutex);
+    rings.push_back(ring);
+    if (!merger.joinable())
+    {
+        merger = std::jthread([this](std::stop_token stop) { mergeLoop(std::move(stop)); });
+    }
+    return Producer(std::move(ring), *this);
+}
+
+/**
+ * @brief Merges every value pushed so far by any producer into the container.
+ *
+ * Once flush() returns, every push that happened before the call is visible to the
+ * snapshots and traversals taken afterwards.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::flush()
+{
+    std::lock_guard<std::mutex> lock(merge_mutex);
+    drainRings();
+}
+
+/**
+ * @brief Stops the background merger and merges every value still buffered by producers.
+ * @return The snapshot holding every value pushed or added before the call.
+ *
+ * Producers must have stopped pushing. The container stays usable: writes publish new
+ * snapshots as before, and the next producer() starts a new merger.
+ */
+template <typename Storage>
+auto BasicConcurrentMagicalContainer<Storage>::close() -> Snapshot
+{
+    if (merger.joinable())
+    {
+        merger.request_stop();
+        merger.join();
+    }
+    std::lock_guard<std::mutex> lock(merge_mutex);
+    drainRings();
+    return snapshot();
+}
+
+/**
+ * @brief Makes a snapshot the one readers see. The caller holds write_mutex.
+ * @param next The new snapshot.
+ *
+ * The previous snapshot pointer is retired and freed once no reader announces it any more,
+ * which is usually right away. Readers that already took a reference keep the snapshot itself
+ * alive through it.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::publish(Snapshot next)
+{
+    retired.emplace_back(current.exchange(new Snapshot(std::move(next)), std::memory_order_seq_cst));
+    std::erase_if(retired, [](const std::unique_ptr<const Snapshot> &old) { return !HazardPointer::isProtected(old.get()); });
+}
+
+/**
+ * @brief Queues a single-element write and waits until it is published or failed.
+ * @param write The write, which lives until the call returns.
+ * @throws std::runtime_error if the write failed. Nothing of it is published then.
+ *
+ * The writer that next takes write_mutex applies every queued write, so while one write copies
+ * the container, the writes arriving in the meantime are folded into the following copy.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::combine(PendingWrite &write)
+{
+    write.next = pending.load(std::memory_order_relaxed);
+    while (!pending.compare_exchange_weak(write.next, &write, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+    {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        if (!write.done)
+        {
+            applyPending();
+        }
+    }
+    if (write.error)
+    {
+        std::rethrow_exception(write.error);
+    }
+}
+
+/**
+ * @brief Applies every queued single-element write to one copy and publishes it. The caller holds write_mutex.
+ *
+ * The writes are applied in the order they were queued. A removal of a missing element fails
+ * alone, leaving the copy unchanged. Any other failure, such as running out of memory, fails
+ * the whole batch and publishes nothing.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::applyPending()
+{
+    std::vector<PendingWrite *> batch;
+    for (PendingWrite *write = pending.exchange(nullptr, std::memory_order_acquire); write != nullptr; write = write->next)
+    {
+        batch.push_back(write);
+    }
+    std::reverse(batch.begin(), batch.end());
+    try
+    {
+        auto next = std::make_shared<Container>(**current.load(std::memory_order_acquire));
+        for (PendingWrite *write : batch)
+        {
+            try
+            {
+                if (write->remove)
+                {
+                    next->removeElement(write->element);
+                }
+                else
+                {
+                    next->addElement(write->element);
+                }
+            }
+            catch (const std::runtime_error &)
+            {
+                write->error = std::current_exception();
+            }
+        }
+        publish(std::move(next));
+    }
+    catch (...)
+    {
+        for (PendingWrite *write : batch)
+        {
+            write->error = std::current_exception();
+        }
+    }
+    for (PendingWrite *write : batch)
+    {
+        write->done = true;
+    }
+}
+
+/**
+ * @brief Wakes the merger ahead of its next pass.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::requestMerge()
+{
+    {
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        merge_requested = true;
+    }
+    merge_wakeup.notify_one();
+}
+
+/**
+ * @brief Body of the merger thread: drains the rings every merge_interval or when woken.
+ * @param stop Token signalled when the container is destroyed.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::mergeLoop(std::stop_token stop)
+{
+    std::unique_lock<std::mutex> lock(merge_mutex);
+    while (!stop.stop_requested())
+    {
+        merge_wakeup.wait_for(lock, stop, merge_interval, [this] { return merge_requested; });
+        merge_requested = false;
+        drainRings();
+    }
+}
+
+/**
+ * @brief Moves the content of every ring into the container as one sorted batch.
+ *
+ * The caller holds merge_mutex, which makes it the only consumer of the rings. Rings whose
+ * producer is gone are dropped once empty.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::drainRings()
+{
+    std::vector<int> batch;
+    for (const std::shared_ptr<IngestRing> &ring : rings)
+    {
+        ring->drainInto(batch);
+    }
+    std::erase_if(rings, [](const std::shared_ptr<IngestRing> &ring) { return ring.use_count() == 1 && ring->empty(); });
+    if (!batch.empty())
+    {
+        addElements(batch);
+    }
+}
+
+/**
+ * @brief Binds a producer to its ring and container.
+ * @param ring The ring owned by this producer.
+ * @param owner The container draining the ring.
+ */
+template <typename Storage>
+BasicConcurrentMagicalContainer<Storage>::Producer::Producer(std::shared_ptr<IngestRing> ring, BasicConcurrentMagicalContainer &owner)
+    : ring(std::move(ring)), owner(&owner)
+{
+}
+
+/**
+ * @brief Queues an element for insertion without taking a lock.
+ * @param element The element to add.
+ * @throws std::runtime_error if the producer is not bound to a container.
+ *
+ * The element becomes visible after the next merge pass or flush(). When the ring is full,
+ * the merger is woken and the call waits for it to make room.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::Producer::push(int element)
+{
+    if (ring == nullptr)
+    {
+        throw std::runtime_error("Producer is not bound to a container");
+    }
+    while (!ring->tryPush(element))
+    {
+        owner->requestMerge();
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief Adds an element to the container.
+ * @param element The element to add.
+ *
+ * Returns once the element is published, possibly in the same snapshot as concurrent writes.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::addElement(int element)
+{
+    PendingWrite write{element, false};
+    combine(write);
+}
+
+/**
+ * @brief Adds every element of a batch as one write.
+ * @param elements The elements to add, in any order.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::addElements(std::span<const int> elements)
+{
+    update([elements](Container &container) { container.addElements(elements); });
+}
+
+/**
+ * @brief Adds every element of a braced list as one write.
+ * @param elements The elements to add, in any order.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::addElements(std::initializer_list<int> elements)
+{
+    addElements(std::span<const int>(elements.begin(), elements.size()));
+}
+
+/**
+ * @brief Removes an element from the container.
+ * @param element The element to remove.
+ * @throws std::runtime_error if the element is not found. Concurrent writes published with it are not affected.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::removeElement(int element)
+{
+    PendingWrite write{element, true};
+    combine(write);
+}
+
+/**
+ * @brief Removes every element of a batch as one write.
+ * @param elements The elements to remove, in any order.
+ * @throws std::runtime_error if an element is not found. Nothing is published then.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::removeElements(std::span<const int> elements)
+{
+    update([elements](Container &container) { container.removeElements(elements); });
+}
+
+/**
+ * @brief Removes every element of a braced list as one write.
+ * @param elements The elements to remove, in any order.
+ * @throws std::runtime_error if an element is not found. Nothing is published then.
+ */
+template <typename Storage>
+void BasicConcurrentMagicalContainer<Storage>::removeElements(std::initializer_list<int> elements)
+{
+    removeElements(std::span<const int>(elements.begin(), elements.size()));
+}
+
+/**
+ * @brief Returns the number of elements in the current snapshot.
+ * @return The number of elements.
+ */
+template <typename Storage>
+size_t BasicConcurrentMagicalContainer<Storage>::size() const
+{
+    return snapshot()->size();
+}
+
+/**
+ * @brief Returns the current snapshot without taking a lock.
+ * @return The snapshot. It never changes and stays alive while the pointer is held.
+ *
+ * The published pointer is announced in the thread's HazardPointer and loaded again: if it is
+ * still published, no writer can free it before the reference below is taken.
+ */
+template <typename Storage>
+typename BasicConcurrentMagicalContainer<Storage>::Snapshot BasicConcurrentMagicalContainer<Storage>::snapshot() const
+{
+    HazardPointer &hazard = HazardPointer::local();
+    const Snapshot *published = current.load(std::memory_order_acquire);
+    for (;;)
+    {
+        hazard.protect(published);
+        const Snapshot *again = current.load(std::memory_order_seq_cst);
+        if (again == published)
+        {
+            break;
+        }
+        published = again;
+    }
+    Snapshot pinned = *published;
+    hazard.protect(nullptr);
+    return pinned;
+}
+
+/**
+ * @brief Returns an ascending traversal of the current snapshot.
+ * @return The traversal, pinning the snapshot.
+ */
+template <typename Storage>
+auto BasicConcurrentMagicalContainer<Storage>::ascending() const -> PinnedTraversal<typename Container::AscendingIterator>
+{
+    return PinnedTraversal<typename Container::AscendingIterator>(snapshot());
+}
+
+/**
+ * @brief Returns a side-cross traversal of the current snapshot.
+ * @return The traversal, pinning the snapshot.
+ */
+template <typename Storage>
+auto BasicConcurrentMagicalContainer<Storage>::sideCross() const -> PinnedTraversal<typename Container::SideCrossIterator>
+{
+    return PinnedTraversal<typename Container::SideCrossIterator>(snapshot());
+}
+
+/**
+ * @brief Returns a traversal of the prime elements of the current snapshot.
+ * @return The traversal, pinning the snapshot.
+ */
+template <typename Storage>
+auto BasicConcurrentMagicalContainer<Storage>::primes() const -> PinnedTraversal<typename Container::PrimeIterator>
+{
+    return PinnedTraversal<typename Container::PrimeIterator>(snapshot());
+}
+
+namespace ariel
+{
+    template class BasicConcurrentMagicalContainer<SortedVectorStorage>;
+    template class BasicConcurrentMagicalContainer<BPlusTreeStorage>;
+} // namespace ariel
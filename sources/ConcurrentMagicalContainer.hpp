@@ -0,0 +1,230 @@
+/**
+ * @file ConcurrentMagicalContainer.hpp
+ * @brief Defines a MagicalContainer that can be read and written from several threads.
+ */
+
+#ifndef CPP_EX4_PARTA_CONCURRENTMAGICALCONTAINER_HPP
+#define CPP_EX4_PARTA_CONCURRENTMAGICALCONTAINER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "HazardPointer.hpp"
+#include "IngestRing.hpp"
+#include "MagicalContainer.hpp"
+
+namespace ariel
+{
+    /**
+     * @class BasicConcurrentMagicalContainer
+     * @brief A MagicalContainer shared between reader and writer threads through immutable snapshots.
+     *
+     * The elements always live in an immutable BasicMagicalContainer (a snapshot). Writers are
+     * serialized by a mutex: each one copies the current snapshot, applies its change to the copy
+     * and publishes the copy. The traversals below keep their snapshot alive, so an iterator can
+     * never observe a reallocation or a half-applied write. A snapshot is released as soon as the
+     * last traversal using it is gone.
+     *
+     * Reads are lock-free. The current snapshot is published through a plain atomic pointer that
+     * a reader announces in its HazardPointer before taking a reference to it, and writers only
+     * free an unpublished snapshot once no reader announces it. A reader never waits for a lock
+     * or for a write; it only loads the pointer again when a write was published in between.
+     *
+     * Every write copies the whole container, so a write costs O(n) however small it is.
+     * Single-element writes from several threads share that cost: addElement() and
+     * removeElement() queue their change, and whichever writer takes the mutex applies every
+     * queued change to one copy and publishes them together. A lone writer still pays one copy
+     * per call, so group changes into addElements(), removeElements() or one update() call when
+     * they come together. For a stream of insertions, give each thread a Producer instead: its
+     * pushes are buffered without locks and a background merger folds all the buffers into the
+     * container in sorted batches. flush() makes them visible at once, and close() or the
+     * destructor merges whatever is still buffered before stopping the merger.
+     *
+     * @tparam Storage The storage policy of the snapshots, as in BasicMagicalContainer.
+     */
+    template <typename Storage = SortedVectorStorage>
+    class BasicConcurrentMagicalContainer
+    {
+    public:
+        using Container = BasicMagicalContainer<Storage>;
+        using Snapshot = std::shared_ptr<const Container>;
+
+        /**
+         * @class PinnedTraversal
+         * @brief A traversal of one snapshot, keeping that snapshot alive while it exists.
+         *
+         * Iterators taken from it stay valid for as long as the PinnedTraversal (or a copy of
+         * it) lives, whatever the writers do in the meantime.
+         */
+        template <typename Iterator>
+        class PinnedTraversal : public std::ranges::view_interface<PinnedTraversal<Iterator>>
+        {
+        private:
+            Snapshot snapshot; /**< The pinned snapshot. */
+            Iterator first;    /**< Iterator to the first element of the traversal. */
+
+        public:
+            PinnedTraversal() = default;
+
+            /**
+             * @brief Pins a snapshot and starts a traversal over it.
+             * @param pinned The snapshot to traverse. It must not be null.
+             */
+            explicit PinnedTraversal(Snapshot pinned) : snapshot(std::move(pinned)), first(*snapshot) {}
+
+            /**
+             * @brief Returns an iterator to the first element.
+             * @return The iterator.
+             */
+            Iterator begin() const
+            {
+                return first;
+            }
+
+            /**
+             * @brief Returns the sentinel ending the traversal.
+             * @return The sentinel.
+             */
+            std::default_sentinel_t end() const
+            {
+                return std::default_sentinel;
+            }
+
+            /**
+             * @brief Returns the snapshot being traversed.
+             * @return The snapshot.
+             */
+            const Container &container() const
+            {
+                return *snapshot;
+            }
+        };
+
+        /**
+         * @class Producer
+         * @brief Handle through which one thread streams insertions into the container.
+         *
+         * Each producer owns a lock-free ring, so producers never contend with each other.
+         * A producer is used by one thread at a time and must not outlive its container.
+         */
+        class Producer
+        {
+        private:
+            std::shared_ptr<IngestRing> ring;                /**< The buffer drained by the merger. */
+            BasicConcurrentMagicalContainer *owner = nullptr; /**< The container fed by this producer. */
+
+            Producer(std::shared_ptr<IngestRing> ring, BasicConcurrentMagicalContainer &owner);
+
+            friend class BasicConcurrentMagicalContainer;
+
+        public:
+            Producer() = default;
+            Producer(const Producer &) = delete;
+            Producer &operator=(const Producer &) = delete;
+            Producer(Producer &&other) noexcept = default;
+            Producer &operator=(Producer &&other) noexcept = default;
+            ~Producer() = default;
+
+            void push(int element);
+        };
+
+        /**
+         * @brief How long the merger sleeps between two passes when nobody wakes it.
+         */
+        static constexpr std::chrono::milliseconds merge_interval{1};
+
+        BasicConcurrentMagicalContainer();
+        BasicConcurrentMagicalContainer(const BasicConcurrentMagicalContainer &) = delete;
+        BasicConcurrentMagicalContainer &operator=(const BasicConcurrentMagicalContainer &) = delete;
+        ~BasicConcurrentMagicalContainer();
+
+        Producer producer();
+        void flush();
+        Snapshot close();
+
+        void addElement(int element);
+        void addElements(std::span<const int> elements);
+        void addElements(std::initializer_list<int> elements);
+        void removeElement(int element);
+        void removeElements(std::span<const int> elements);
+        void removeElements(std::initializer_list<int> elements);
+        size_t size() const;
+
+        Snapshot snapshot() const;
+        PinnedTraversal<typename Container::AscendingIterator> ascending() const;
+        PinnedTraversal<typename Container::SideCrossIterator> sideCross() const;
+        PinnedTraversal<typename Container::PrimeIterator> primes() const;
+
+        /**
+         * @brief Applies a group of changes and publishes them as one new snapshot.
+         * @param function Callable invoked with a private, modifiable copy of the current snapshot.
+         * @throws Any exception thrown by function. The copy is then discarded and readers keep
+         * seeing the previous snapshot.
+         *
+         * Readers see either none or all of the changes made by function. The current snapshot
+         * is copied before function runs, so every call costs O(size()) on top of its changes.
+         */
+        template <typename Function>
+        void update(Function function)
+        {
+            std::lock_guard<std::mutex> lock(write_mutex);
+            auto next = std::make_shared<Container>(**current.load(std::memory_order_acquire));
+            function(*next);
+            publish(std::move(next));
+        }
+
+    private:
+        /**
+         * @struct PendingWrite
+         * @brief A single-element write waiting for a writer to apply it, on its caller's stack.
+         */
+        struct PendingWrite
+        {
+            int element;                  /**< The element to add or remove. */
+            bool remove;                  /**< True to remove the element, false to add it. */
+            std::exception_ptr error;     /**< Why the write failed, set by the writer applying it. */
+            bool done = false;            /**< Set under write_mutex once the write is published or failed. */
+            PendingWrite *next = nullptr; /**< The write queued before this one. */
+        };
+
+        std::atomic<const Snapshot *> current;                 /**< The published snapshot, read under a HazardPointer. */
+        std::mutex write_mutex;                                /**< Serializes the writers. */
+        std::vector<std::unique_ptr<const Snapshot>> retired;  /**< Unpublished snapshots still announced by a reader, guarded by write_mutex. */
+        std::atomic<PendingWrite *> pending{nullptr};          /**< The queued single-element writes, newest first. */
+
+        static_assert(std::atomic<const Snapshot *>::is_always_lock_free);
+
+        std::vector<std::shared_ptr<IngestRing>> rings; /**< The rings of every producer, guarded by merge_mutex. */
+        std::mutex merge_mutex;                         /**< Held by whoever drains the rings. */
+        std::condition_variable_any merge_wakeup;       /**< Wakes the merger before its interval ends. */
+        bool merge_requested = false;                   /**< Set when a producer found its ring full. */
+        std::jthread merger;                            /**< The background merger, started by the first producer(). */
+
+        void publish(Snapshot next);
+        void combine(PendingWrite &write);
+        void applyPending();
+        void requestMerge();
+        void mergeLoop(std::stop_token stop);
+        void drainRings();
+    };
+
+    /**
+     * @brief The default concurrent container, with snapshots kept in a sorted vector.
+     */
+    using ConcurrentMagicalContainer = BasicConcurrentMagicalContainer<SortedVectorStorage>;
+
+    extern template class BasicConcurrentMagicalContainer<SortedVectorStorage>;
+    extern template class BasicConcurrentMagicalContainer<BPlusTreeStorage>;
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_CONCURRENTMAGICALCONTAINER_HPP
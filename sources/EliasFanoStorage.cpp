@@ -0,0 +1,231 @@
+#include "EliasFanoStorage.hpp"
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <iterator>
+using namespace ariel;
+
+/**
+ * @brief Constructs the storage by encoding a vector that is already sorted.
+ * @param sorted_elements The elements, in ascending order.
+ */
+EliasFanoStorage::EliasFanoStorage(std::vector<int> sorted_elements)
+{
+    build(sorted_elements);
+}
+
+/**
+ * @brief Encodes a sorted sequence, replacing the current contents.
+ * @param sorted_elements The elements, in ascending order.
+ *
+ * The number of low bits is floor(log2(range / size)), which keeps the unary array at most
+ * about twice as long as the number of elements.
+ */
+void EliasFanoStorage::build(const std::vector<int> &sorted_elements)
+{
+    count = sorted_elements.size();
+    base = 0;
+    top = 0;
+    low_bits = 0;
+    lows.clear();
+    highs.clear();
+    one_samples.clear();
+    zero_samples.clear();
+    if (count == 0)
+    {
+        return;
+    }
+
+    base = sorted_elements.front();
+    top = static_cast<std::uint64_t>(static_cast<std::int64_t>(sorted_elements.back()) - base);
+    if (top + 1 > count)
+    {
+        low_bits = static_cast<unsigned>(std::bit_width((top + 1) / count)) - 1;
+    }
+
+    std::uint64_t buckets = (top >> low_bits) + 1;
+    auto length = static_cast<std::size_t>(count + buckets);
+    highs.assign(length / 64 + 1, 0);
+    lows.assign(count * low_bits / 64 + 2, 0);
+    one_samples.reserve(count / select_sample + 1);
+
+    std::uint64_t low_mask = (std::uint64_t{1} << low_bits) - 1;
+    for (std::size_t rank = 0; rank < count; ++rank)
+    {
+        auto offset = static_cast<std::uint64_t>(static_cast<std::int64_t>(sorted_elements[rank]) - base);
+        auto position = static_cast<std::size_t>((offset >> low_bits) + rank);
+        highs[position / 64] |= std::uint64_t{1} << (position % 64);
+        if (rank % select_sample == 0)
+        {
+            one_samples.push_back(position);
+        }
+
+        if (low_bits > 0)
+        {
+            std::size_t bit = rank * low_bits;
+            unsigned shift = bit % 64;
+            lows[bit / 64] |= (offset & low_mask) << shift;
+            if (shift + low_bits > 64)
+            {
+                lows[bit / 64 + 1] |= (offset & low_mask) >> (64 - shift);
+            }
+        }
+    }
+
+    // One zero ends every bucket, so there are exactly buckets zeros; the padding after them is ignored
+    zero_samples.reserve(static_cast<std::size_t>(buckets / select_sample + 1));
+    std::uint64_t zeros_before = 0;
+    for (std::size_t word = 0; word < highs.size() && zero_samples.size() * select_sample < buckets; ++word)
+    {
+        std::uint64_t zeros = ~highs[word];
+        std::uint64_t counts = broadword::prefixCounts(zeros);
+        std::uint64_t in_word = counts >> 56;
+        std::uint64_t next = zero_samples.size() * select_sample;
+        while (next < zeros_before + in_word && next < buckets)
+        {
+            zero_samples.push_back(word * 64 + broadword::selectInWord(zeros, counts, static_cast<unsigned>(next - zeros_before)));
+            next += select_sample;
+        }
+        zeros_before += in_word;
+    }
+}
+
+/**
+ * @brief Decodes every element in order.
+ * @return The elements, in ascending order.
+ *
+ * The unary array is walked word by word, so no select is needed.
+ */
+std::vector<int> EliasFanoStorage::toVector() const
+{
+    std::vector<int> elements;
+    elements.reserve(count);
+    for (std::size_t word = 0; elements.size() < count; ++word)
+    {
+        for (std::uint64_t bits = highs[word]; bits != 0 && elements.size() < count; bits &= bits - 1)
+        {
+            std::size_t rank = elements.size();
+            std::uint64_t high = word * 64 + static_cast<unsigned>(std::countr_zero(bits)) - rank;
+            elements.push_back(static_cast<int>(static_cast<std::int64_t>(base) + static_cast<std::int64_t>(high << low_bits | low(rank))));
+        }
+    }
+    return elements;
+}
+
+/**
+ * @brief Returns the rank of the first element not less than value.
+ * @param value The value to look for.
+ * @return The rank, or size() if every element is less than value.
+ *
+ * The high bits of value name its bucket, whose elements are found with two selectZero()
+ * calls; only the low bits inside that bucket are binary searched.
+ */
+std::size_t EliasFanoStorage::lowerBound(int value) const
+{
+    if (count == 0 || value <= base)
+    {
+        return 0;
+    }
+    auto offset = static_cast<std::uint64_t>(static_cast<std::int64_t>(value) - base);
+    if (offset > top)
+    {
+        return count;
+    }
+
+    std::uint64_t bucket = offset >> low_bits;
+    std::size_t first = bucket == 0 ? 0 : static_cast<std::size_t>(selectZero(static_cast<std::size_t>(bucket - 1)) + 1 - bucket);
+    auto last = static_cast<std::size_t>(selectZero(static_cast<std::size_t>(bucket)) - bucket);
+    std::uint64_t target = offset & ((std::uint64_t{1} << low_bits) - 1);
+    while (first < last)
+    {
+        std::size_t middle = first + (last - first) / 2;
+        if (low(middle) < target)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+/**
+ * @brief Returns the rank of the first element greater than value.
+ * @param value The value to look for.
+ * @return The rank, or size() if no element is greater than value.
+ */
+std::size_t EliasFanoStorage::upperBound(int value) const
+{
+    return value == INT_MAX ? count : lowerBound(value + 1);
+}
+
+/**
+ * @brief Inserts a value, keeping the elements sorted.
+ * @param value The value to insert.
+ *
+ * The sequence is decoded and encoded again, O(N).
+ */
+void EliasFanoStorage::insert(int value)
+{
+    std::vector<int> elements = toVector();
+    elements.insert(std::upper_bound(elements.begin(), elements.end(), value), value);
+    build(elements);
+}
+
+/**
+ * @brief Merges an already sorted batch of values into the storage.
+ * @param sorted_values The values to insert, in ascending order.
+ *
+ * The batch is merged with the decoded sequence and everything is encoded once.
+ */
+void EliasFanoStorage::insertSorted(std::span<const int> sorted_values)
+{
+    std::vector<int> current = toVector();
+    std::vector<int> merged;
+    merged.reserve(current.size() + sorted_values.size());
+    std::merge(current.begin(), current.end(), sorted_values.begin(), sorted_values.end(), std::back_inserter(merged));
+    build(merged);
+}
+
+/**
+ * @brief Removes a single occurrence of a value.
+ * @param value The value to remove.
+ * @return True if the value was found and removed, false otherwise.
+ */
+bool EliasFanoStorage::erase(int value)
+{
+    std::size_t rank = lowerBound(value);
+    if (rank == count || (*this)[rank] != value)
+    {
+        return false;
+    }
+    std::vector<int> elements = toVector();
+    elements.erase(elements.begin() + static_cast<std::ptrdiff_t>(rank));
+    build(elements);
+    return true;
+}
+
+/**
+ * @brief Removes one occurrence of every value of a sorted batch.
+ * @param sorted_values The values to remove, in ascending order. All of them must be stored.
+ */
+void EliasFanoStorage::eraseSorted(std::span<const int> sorted_values)
+{
+    std::vector<int> current = toVector();
+    std::vector<int> remaining;
+    remaining.reserve(current.size() - sorted_values.size());
+    std::set_difference(current.begin(), current.end(), sorted_values.begin(), sorted_values.end(), std::back_inserter(remaining));
+    build(remaining);
+}
+
+/**
+ * @brief Returns the memory held by the storage.
+ * @return The size of the object plus the capacity of its arrays, in bytes.
+ */
+std::size_t EliasFanoStorage::bytes() const
+{
+    return sizeof(*this) + (lows.capacity() + highs.capacity()) * sizeof(std::uint64_t) +
+           (one_samples.capacity() + zero_samples.capacity()) * sizeof(std::size_t);
+}
@@ -0,0 +1,155 @@
+#ifndef CPP_EX4_PARTA_ELIASFANOSTORAGE_HPP
+#define CPP_EX4_PARTA_ELIASFANOSTORAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+#include "Broadword.hpp"
+
+namespace ariel
+{
+    /**
+     * @class EliasFanoStorage
+     * @brief Storage policy keeping the elements of a MagicalContainer Elias-Fano compressed.
+     *
+     * Every element is stored as its offset from the smallest one, split into low bits, packed
+     * in a plain bit array, and high bits, coded in unary in a second bit array. Together they
+     * take about 2 + log2(range / size) bits per element, so a sorted set of ints with small
+     * gaps shrinks 4 to 16 times compared to a vector.
+     *
+     * Sampled positions of the ones and zeros of the unary array make the element with a given
+     * rank (select) and the first element of a high bucket a scan of one or two words, so the
+     * iterators keep their O(1) rank access in both directions and lowerBound() skips straight
+     * to the bucket of the value before a binary search over its low bits.
+     *
+     * Every insertion or removal re-encodes the whole sequence, so this is a backend for large,
+     * read-mostly containers built in bulk.
+     */
+    class EliasFanoStorage
+    {
+    private:
+        static constexpr std::size_t select_sample = 128; /**< One position is sampled every this many ones (or zeros). */
+
+        std::size_t count = 0;                  /**< The number of elements. */
+        int base = 0;                           /**< The smallest element, subtracted from every element. */
+        std::uint64_t top = 0;                  /**< The offset of the largest element from base. */
+        unsigned low_bits = 0;                  /**< The number of low bits stored per element. */
+        std::vector<std::uint64_t> lows;        /**< The low bits of the offsets, packed, plus a spare word. */
+        std::vector<std::uint64_t> highs;       /**< The high bits of the offsets, one set bit per element after one zero per bucket. */
+        std::vector<std::size_t> one_samples;   /**< Position in highs of every select_sample-th set bit. */
+        std::vector<std::size_t> zero_samples;  /**< Position in highs of every select_sample-th clear bit. */
+
+        void build(const std::vector<int> &sorted_elements);
+        std::vector<int> toVector() const;
+
+        /**
+         * @brief Returns the position in a bit array of its rank-th set bit, starting from a sampled position.
+         * @param words The bit array.
+         * @param sample The position of a set bit at or before the one looked for.
+         * @param rank The number of set bits between sample (included) and the one looked for.
+         * @param invert True to look for clear bits instead.
+         * @return The bit position.
+         */
+        static std::size_t selectFrom(const std::vector<std::uint64_t> &words, std::size_t sample, unsigned rank, bool invert)
+        {
+            std::size_t word = sample / 64;
+            std::uint64_t flip = invert ? ~std::uint64_t{0} : 0;
+            std::uint64_t bits = (words[word] ^ flip) & (~std::uint64_t{0} << (sample % 64));
+            std::uint64_t counts = broadword::prefixCounts(bits);
+            for (auto total = static_cast<unsigned>(counts >> 56); rank >= total; total = static_cast<unsigned>(counts >> 56))
+            {
+                rank -= total;
+                bits = words[++word] ^ flip;
+                counts = broadword::prefixCounts(bits);
+            }
+            return word * 64 + broadword::selectInWord(bits, counts, rank);
+        }
+
+        /**
+         * @brief Returns the position in highs of the set bit of the element with the given rank.
+         * @param rank The rank of the element.
+         * @return The bit position.
+         */
+        std::size_t selectOne(std::size_t rank) const
+        {
+            return selectFrom(highs, one_samples[rank / select_sample], static_cast<unsigned>(rank % select_sample), false);
+        }
+
+        /**
+         * @brief Returns the position in highs of the clear bit ending the given bucket.
+         * @param rank The bucket, that is the rank of the clear bit.
+         * @return The bit position.
+         */
+        std::size_t selectZero(std::size_t rank) const
+        {
+            return selectFrom(highs, zero_samples[rank / select_sample], static_cast<unsigned>(rank % select_sample), true);
+        }
+
+        /**
+         * @brief Returns the low bits of the element with the given rank.
+         * @param rank The rank of the element.
+         * @return The low bits of its offset from base.
+         */
+        std::uint64_t low(std::size_t rank) const
+        {
+            if (low_bits == 0)
+            {
+                return 0;
+            }
+            std::size_t bit = rank * low_bits;
+            std::size_t word = bit / 64;
+            unsigned shift = bit % 64;
+            std::uint64_t value = lows[word] >> shift;
+            if (shift + low_bits > 64)
+            {
+                value |= lows[word + 1] << (64 - shift);
+            }
+            return value & ((std::uint64_t{1} << low_bits) - 1);
+        }
+
+    public:
+        using value_type = int;
+        using value_compare = std::less<int>;
+        using const_reference = int;
+
+        /**
+         * @brief False, elements are decoded on access and returned by value.
+         */
+        static constexpr bool is_contiguous = false;
+
+        EliasFanoStorage() = default;
+        explicit EliasFanoStorage(std::vector<int> sorted_elements);
+
+        /**
+         * @brief Returns the number of stored elements.
+         * @return The number of elements.
+         */
+        std::size_t size() const
+        {
+            return count;
+        }
+
+        /**
+         * @brief Decodes the element with the given rank.
+         * @param index The rank of the element (0 is the smallest).
+         * @return The element at that rank.
+         */
+        int operator[](std::size_t index) const
+        {
+            std::uint64_t high = selectOne(index) - index;
+            return static_cast<int>(static_cast<std::int64_t>(base) + static_cast<std::int64_t>(high << low_bits | low(index)));
+        }
+
+        std::size_t lowerBound(int value) const;
+        std::size_t upperBound(int value) const;
+        void insert(int value);
+        void insertSorted(std::span<const int> sorted_values);
+        bool erase(int value);
+        void eraseSorted(std::span<const int> sorted_values);
+        std::size_t bytes() const;
+    };
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_ELIASFANOSTORAGE_HPP
@@ -0,0 +1,65 @@
+#include "HazardPointer.hpp"
+#include <memory>
+using namespace ariel;
+
+namespace
+{
+    std::atomic<HazardPointer *> slots{nullptr}; /**< Head of the list of every slot ever created. */
+} // namespace
+
+/**
+ * @brief Returns the slot of the calling thread, claiming one on the first call.
+ * @return The slot. It is released when the thread exits.
+ */
+HazardPointer &HazardPointer::local()
+{
+    thread_local const std::unique_ptr<HazardPointer, void (*)(HazardPointer *)> slot(claim(), [](HazardPointer *hazard) {
+        hazard->protect(nullptr);
+        hazard->claimed.store(false, std::memory_order_release);
+    });
+    return *slot;
+}
+
+/**
+ * @brief Checks whether any thread announced an object.
+ * @param object The object.
+ * @return True if a slot holds it.
+ *
+ * Called by the writer after it unpublished the object: a false result means no reader can
+ * reach it any more, so it may be freed.
+ */
+bool HazardPointer::isProtected(const void *object)
+{
+    for (HazardPointer *slot = slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next)
+    {
+        if (slot->pointer.load(std::memory_order_seq_cst) == object)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Takes a slot given back by an exited thread, or adds a new one to the list.
+ * @return The slot, owned by the caller.
+ */
+HazardPointer *HazardPointer::claim()
+{
+    for (HazardPointer *slot = slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next)
+    {
+        bool expected = false;
+        if (slot->claimed.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        {
+            return slot;
+        }
+    }
+    // The slots live as long as the program, since isProtected() may walk them at any time
+    auto *slot = new HazardPointer();
+    slot->claimed.store(true, std::memory_order_relaxed);
+    slot->next = slots.load(std::memory_order_relaxed);
+    while (!slots.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+    return slot;
+}
@@ -0,0 +1,44 @@
+#ifndef CPP_EX4_PARTA_HAZARDPOINTER_HPP
+#define CPP_EX4_PARTA_HAZARDPOINTER_HPP
+
+#include <atomic>
+
+namespace ariel
+{
+    /**
+     * @class HazardPointer
+     * @brief A slot through which one thread announces the shared object it is about to read.
+     *
+     * A writer that unpublishes an object only frees it once no slot holds it, so a reader that
+     * announced an object and then found it still published can use it without taking a lock.
+     * The slots form a global list that only grows: each thread claims one on its first read and
+     * gives it back when it exits, for the next thread to reuse.
+     */
+    class HazardPointer
+    {
+    public:
+        static HazardPointer &local();
+        static bool isProtected(const void *object);
+
+        /**
+         * @brief Announces that this thread is about to read an object.
+         * @param object The object, or nullptr to clear the slot.
+         *
+         * The store is sequentially consistent, so a reader that loads the published pointer
+         * again after it cannot miss a writer that unpublished the object in between.
+         */
+        void protect(const void *object)
+        {
+            pointer.store(object, std::memory_order_seq_cst);
+        }
+
+    private:
+        std::atomic<const void *> pointer{nullptr}; /**< The announced object. */
+        std::atomic<bool> claimed{false};           /**< Whether a thread owns this slot. */
+        HazardPointer *next = nullptr;              /**< The next slot, set once before publication. */
+
+        static HazardPointer *claim();
+    };
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_HAZARDPOINTER_HPP
@@ -0,0 +1,45 @@
+#include "IngestRing.hpp"
+using namespace ariel;
+
+/**
+ * @brief Queues a value. Only the producer thread may call this.
+ * @param value The value to queue.
+ * @return True if the value was queued, false if the ring is full.
+ */
+bool IngestRing::tryPush(int value)
+{
+    std::size_t position = tail.load(std::memory_order_relaxed);
+    if (position - head.load(std::memory_order_acquire) == capacity)
+    {
+        return false;
+    }
+    slots[position & (capacity - 1)] = value;
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Moves every queued value to the end of a vector. Only the consumer may call this.
+ * @param out The vector receiving the values, in the order they were pushed.
+ * @return The number of values moved.
+ */
+std::size_t IngestRing::drainInto(std::vector<int> &out)
+{
+    std::size_t first = head.load(std::memory_order_relaxed);
+    std::size_t last = tail.load(std::memory_order_acquire);
+    for (std::size_t position = first; position != last; ++position)
+    {
+        out.push_back(slots[position & (capacity - 1)]);
+    }
+    head.store(last, std::memory_order_release);
+    return last - first;
+}
+
+/**
+ * @brief Checks whether the ring holds no value.
+ * @return True if nothing is queued.
+ */
+bool IngestRing::empty() const
+{
+    return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+}
@@ -0,0 +1,37 @@
+#ifndef CPP_EX4_PARTA_INGESTRING_HPP
+#define CPP_EX4_PARTA_INGESTRING_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace ariel
+{
+    /**
+     * @class IngestRing
+     * @brief Bounded, lock-free single-producer single-consumer queue of pending insertions.
+     *
+     * One thread pushes and one thread (at a time) drains. The two sides only share the head
+     * and tail counters, each on its own cache line, so pushing never takes a lock and never
+     * contends with other producers.
+     */
+    class IngestRing
+    {
+    public:
+        static constexpr std::size_t capacity = 4096; /**< Slots in the ring, a power of two. */
+
+        bool tryPush(int value);
+        std::size_t drainInto(std::vector<int> &out);
+        bool empty() const;
+
+    private:
+        static constexpr std::size_t cache_line = 64;
+
+        alignas(cache_line) std::atomic<std::size_t> head{0}; /**< Next slot to drain, written by the consumer. */
+        alignas(cache_line) std::atomic<std::size_t> tail{0}; /**< Next slot to fill, written by the producer. */
+        alignas(cache_line) std::array<int, capacity> slots{}; /**< The queued values. */
+    };
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_INGESTRING_HPP
@@ -10,31 +10,181 @@
 #ifndef CPP_EX4_PARTA_MAGICALCONTAINER_HPP
 #define CPP_EX4_PARTA_MAGICALCONTAINER_HPP
 
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
-#include <math.h>
+#include "Aggregates.hpp"
+#include "MappedStorage.hpp"
 #include "Mystical_Iterator.hpp"
+#include "ParallelTraversal.hpp"
+#include "Primality.hpp"
+#include "PrimeSieve.hpp"
+#include "SetAlgebra.hpp"
+#include "Snapshot.hpp"
+#include "SortedVectorStorage.hpp"
+#include "BPlusTreeStorage.hpp"
+#include "EliasFanoStorage.hpp"
+#include "RoaringStorage.hpp"
+#include "VersionStamp.hpp"
 
 namespace ariel
 {
     /**
-     * @class MagicalContainer
+     * @struct SortedRangeTag
+     * @brief Tag type selecting the MagicalContainer constructor that adopts an already sorted range.
+     */
+    struct SortedRangeTag
+    {
+        explicit SortedRangeTag() = default;
+    };
+
+    /**
+     * @brief Tag value passed to MagicalContainer to adopt a pre-sorted vector without re-sorting it.
+     */
+    inline constexpr SortedRangeTag sorted_range{};
+
+    /**
+     * @class BasicMagicalContainer
      * @brief A container class that holds mystical elements.
      *
-     * The MagicalContainer class stores a collection of mystical elements. It provides
+     * The BasicMagicalContainer class stores a collection of mystical elements. It provides
      * methods to add and remove elements from the container, as well as access the size
      * of the container.
+     *
+     * @tparam Storage The storage policy keeping the elements sorted. It must name its element
+     * type and ordering as value_type and value_compare, provide size(), rank access through
+     * operator[], lowerBound(), upperBound(), insert(), insertSorted(), erase() and
+     * eraseSorted(), and be constructible from a sorted std::vector<value_type>.
+     * SortedVectorStorage suits read-mostly containers, BPlusTreeStorage write-heavy ones,
+     * EliasFanoStorage large read-mostly ones that must stay small in memory, RoaringStorage
+     * dense subsets of a bounded range, and
+     * BasicSortedVectorStorage<T, Compare> holds any other element type (see MagicalContainerOf).
+     *
+     * The prime index and PrimeIterator only exist for integral element types; the arithmetic
+     * aggregates (sum(), histogram()) only for arithmetic ones, and histogram() only for the
+     * default ascending order, since its bucket edges are computed in that order.
+     *
+     * The element access and movement operators of the iterators are defined inline in this
+     * header, so loops over a SortedVectorStorage container compile to plain indexed reads the
+     * optimizer can unroll and vectorize without LTO.
+     *
+     * Any change to the elements invalidates the iterators created before it. When
+     * MAGICAL_CHECKED_ITERATORS is 1 (the Makefile sets it for demo and test), reading through
+     * or moving such an iterator throws std::runtime_error instead of returning stale data.
      */
-    class MagicalContainer
+    template <typename Storage = SortedVectorStorage>
+    class BasicMagicalContainer
     {
+    public:
+        using value_type = typename Storage::value_type;
+        using value_compare = typename Storage::value_compare;
+
+        /**
+         * @brief True when the container keeps a prime index, that is for integral element types.
+         */
+        static constexpr bool has_primes = std::integral<value_type> && !std::same_as<value_type, bool>;
+
+        /**
+         * @brief The type returned by sum(): 64-bit integers for integral elements, double otherwise.
+         */
+        using sum_type = std::conditional_t<std::is_floating_point_v<value_type>, double,
+                                            std::conditional_t<std::is_signed_v<value_type>, std::int64_t, std::uint64_t>>;
+
     private:
-        std::vector<int> mystical_elements; /**< The underlying vector to store the elements. */
+        Storage mystical_elements; /**< The underlying storage to store the elements. */
+        Storage prime_elements;    /**< The prime elements only, kept in step with mystical_elements. */
+        ModificationCounter modifications; /**< Bumped by every change, checked by the iterators in checked builds. */
+
+        static bool isPrime(value_type value);
+        static std::vector<value_type> primesOf(std::span<const value_type> sorted_values);
+        static std::span<const value_type> sortedSpan(const Storage &storage, std::vector<value_type> &buffer);
+        template <typename Operation>
+        BasicMagicalContainer combine(const BasicMagicalContainer &other, Operation operation) const;
 
     public:
-        MagicalContainer();
-        void addElement(int element);
-        void removeElement(int element);
-        size_t size();
+        BasicMagicalContainer();
+        BasicMagicalContainer(SortedRangeTag, std::vector<value_type> sorted_elements);
+        void addElement(const value_type &element);
+        void addElements(std::span<const value_type> elements);
+        void addElements(std::initializer_list<value_type> elements);
+
+        /**
+         * @brief Adds every element of the range [first, last) to the container.
+         * @param first Iterator to the first element to add.
+         * @param last Iterator past the last element to add.
+         *
+         * The elements are appended and then sorted and merged into the container in a single
+         * pass, so loading k elements into a container of n costs O(n + k log k) instead of
+         * k separate insertions.
+         */
+        template <typename InputIt>
+        void addElements(InputIt first, InputIt last)
+        {
+            std::vector<value_type> batch(first, last);
+            std::sort(batch.begin(), batch.end(), value_compare());
+            mystical_elements.insertSorted(batch);
+            if constexpr (has_primes)
+            {
+                prime_elements.insertSorted(primesOf(batch));
+            }
+            modifications.bump();
+        }
+
+        void removeElement(const value_type &element);
+        void removeElements(std::span<const value_type> elements);
+        void removeElements(std::initializer_list<value_type> elements);
+
+        /**
+         * @brief Returns the number of elements in the container.
+         * @return The size of the container.
+         */
+        size_t size() const
+        {
+            return mystical_elements.size();
+        }
+
+        sum_type sum() const
+            requires std::is_arithmetic_v<value_type>;
+        value_type min() const;
+        value_type max() const;
+        std::size_t countInRange(const value_type &low, const value_type &high) const;
+        std::vector<std::size_t> histogram(value_type low, value_type high, std::size_t buckets) const
+            requires std::is_arithmetic_v<value_type> && std::same_as<value_compare, std::less<value_type>>;
+
+        BasicMagicalContainer intersect(const BasicMagicalContainer &other) const;
+        BasicMagicalContainer unite(const BasicMagicalContainer &other) const;
+        BasicMagicalContainer subtract(const BasicMagicalContainer &other) const;
+
+        void save(const std::string &path) const
+            requires std::is_trivially_copyable_v<value_type>;
+        static BasicMagicalContainer load(const std::string &path)
+            requires std::is_trivially_copyable_v<value_type>;
+
+        /**
+         * @brief The legacy iterator_category of an iterator whose C++20 iterator_concept is Tag.
+         *
+         * Cpp17ForwardIterator and every stronger category require reference to be a real
+         * reference. Storages that decode their elements on access (EliasFanoStorage,
+         * RoaringStorage) return them by value, so their iterators only claim to be input
+         * iterators to legacy algorithms, while iterator_concept keeps their full strength for
+         * the standard concepts and ranges.
+         */
+        template <typename Tag>
+        using LegacyCategory = std::conditional_t<std::is_reference_v<typename Storage::const_reference>, Tag, std::input_iterator_tag>;
 
         /**
          * @class AscendingIterator
@@ -43,32 +193,248 @@ namespace ariel
          * The AscendingIterator class provides an iterator that allows traversing the elements
          * in ascending order in the MagicalContainer.
          */
-        class AscendingIterator : public Mystical_Iterator
+        class AscendingIterator : public Mystical_Iterator_Base<AscendingIterator>
         {
         private:
-            MagicalContainer *magic_ctr; /**< Pointer to the MagicalContainer object. */
+            friend class BasicMagicalContainer;
+
+            const BasicMagicalContainer *magic_ctr; /**< Pointer to the MagicalContainer object. */
             std::size_t index;           /**< Index indicating the current position in the container. */
+            [[no_unique_address]] VersionStamp stamp; /**< Container version at creation, see MAGICAL_CHECKED_ITERATORS. */
 
         public:
-            AscendingIterator(MagicalContainer &magic_ctr);
-            AscendingIterator(const AscendingIterator &other);
-            AscendingIterator(AscendingIterator &&other) noexcept;
+            using iterator_category = LegacyCategory<std::random_access_iterator_tag>;
+            using iterator_concept = std::conditional_t<Storage::is_contiguous, std::contiguous_iterator_tag, std::random_access_iterator_tag>;
+            using value_type = typename Storage::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type *;
+            using reference = typename Storage::const_reference;
+
+            AscendingIterator();
+            AscendingIterator(const BasicMagicalContainer &magic_ctr);
+            AscendingIterator(const BasicMagicalContainer &magic_ctr, const value_type &start_value);
+            /**
+             * @brief Copy constructor for AscendingIterator.
+             * @param other The AscendingIterator to copy from.
+             */
+            AscendingIterator(const AscendingIterator &other) : magic_ctr(other.magic_ctr), index(other.index), stamp(other.stamp) {}
+
+            /**
+             * @brief Move constructor for AscendingIterator.
+             * @param other The other AscendingIterator to move from.
+             */
+            AscendingIterator(AscendingIterator &&other) noexcept : magic_ctr(other.magic_ctr), index(other.index), stamp(other.stamp) {}
             /**
              * @brief Default Destructor for AscendingIterator.
              */
-            ~AscendingIterator() override = default;
+            ~AscendingIterator() = default;
             AscendingIterator &operator=(const AscendingIterator &other);
             AscendingIterator &operator=(AscendingIterator &&other) noexcept;
-            bool operator==(const Mystical_Iterator &other) const override;
-            bool operator!=(const Mystical_Iterator &other) const override;
-            bool operator<(const Mystical_Iterator &other) const override;
-            bool operator>(const Mystical_Iterator &other) const override;
-            bool operator==(const AscendingIterator &other) const;
-            bool operator!=(const AscendingIterator &other) const;
-            bool operator>(const AscendingIterator &other) const;
-            bool operator<(const AscendingIterator &other) const;
-            int operator*() const;
-            AscendingIterator &operator++();
+
+            /**
+             * @brief Returns the position of the iterator, used by the comparison operators.
+             * @return The index of the current element.
+             */
+            std::size_t position() const
+            {
+                return index;
+            }
+
+            /**
+             * @brief Returns the container the iterator walks over.
+             * @return Pointer to the container.
+             */
+            const BasicMagicalContainer *container() const
+            {
+                return magic_ctr;
+            }
+
+            /**
+             * @brief Returns the position of the end of the traversal, used to compare with std::default_sentinel.
+             * @return The number of elements in the container.
+             */
+            std::size_t endPosition() const
+            {
+                return magic_ctr->mystical_elements.size();
+            }
+
+            /**
+             * @brief Dereference operator.
+             * @return The element at the current position of the iterator.
+             * @throws std::runtime_error If the container was modified after the iterator was created (checked builds only).
+             */
+            reference operator*() const
+            {
+                stamp.check(magic_ctr->modifications);
+                return magic_ctr->mystical_elements[index];
+            }
+
+            /**
+             * @brief Member access operator.
+             * @return Pointer to the current element.
+             *
+             * For contiguous storages the pointer is computed from data(), so it is also valid for end().
+             * Storages returning elements by value, such as EliasFanoStorage, have no member access.
+             */
+            pointer operator->() const
+                requires std::is_reference_v<reference>
+            {
+                stamp.check(magic_ctr->modifications);
+                if constexpr (Storage::is_contiguous)
+                {
+                    return magic_ctr->mystical_elements.data() + index;
+                }
+                else
+                {
+                    return &magic_ctr->mystical_elements[index];
+                }
+            }
+
+            /**
+             * @brief Subscript operator.
+             * @param offset The offset from the current position.
+             * @return The element offset positions after the current one.
+             */
+            reference operator[](difference_type offset) const
+            {
+                stamp.check(magic_ctr->modifications);
+                return magic_ctr->mystical_elements[static_cast<std::size_t>(static_cast<difference_type>(index) + offset)];
+            }
+
+            /**
+             * @brief Pre-increment operator.
+             * @return Reference to the incremented iterator.
+             * @throws std::runtime_error If the index is invalid.
+             */
+            AscendingIterator &operator++()
+            {
+                stamp.check(magic_ctr->modifications);
+                if (index == magic_ctr->size())
+                {
+                    throw std::runtime_error("Invalid index");
+                }
+                ++index;
+                return *this;
+            }
+
+            /**
+             * @brief Post-increment operator.
+             * @return A copy of the iterator before it was incremented.
+             * @throws std::runtime_error If the iterator has reached the end.
+             */
+            AscendingIterator operator++(int)
+            {
+                AscendingIterator previous(*this);
+                ++*this;
+                return previous;
+            }
+
+            /**
+             * @brief Pre-decrement operator.
+             * @return Reference to the decremented iterator.
+             * @throws std::runtime_error If the iterator is at the beginning.
+             */
+            AscendingIterator &operator--()
+            {
+                stamp.check(magic_ctr->modifications);
+                if (index == 0)
+                {
+                    throw std::runtime_error("Cannot decrement the iterator past the beginning");
+                }
+                --index;
+                return *this;
+            }
+
+            /**
+             * @brief Post-decrement operator.
+             * @return A copy of the iterator before it was decremented.
+             * @throws std::runtime_error If the iterator is at the beginning.
+             */
+            AscendingIterator operator--(int)
+            {
+                AscendingIterator previous(*this);
+                --*this;
+                return previous;
+            }
+
+            /**
+             * @brief Moves the iterator by offset elements.
+             * @param offset The number of elements to move by, negative to move backwards.
+             * @return Reference to the moved iterator.
+             * @throws std::runtime_error If the iterator would leave the range [begin, end].
+             */
+            AscendingIterator &operator+=(difference_type offset)
+            {
+                stamp.check(magic_ctr->modifications);
+                auto target = static_cast<difference_type>(index) + offset;
+                if (target < 0 || target > static_cast<difference_type>(magic_ctr->size()))
+                {
+                    throw std::runtime_error("Invalid index");
+                }
+                index = static_cast<std::size_t>(target);
+                return *this;
+            }
+
+            /**
+             * @brief Moves the iterator backwards by offset elements.
+             * @param offset The number of elements to move back by.
+             * @return Reference to the moved iterator.
+             * @throws std::runtime_error If the iterator would leave the range [begin, end].
+             */
+            AscendingIterator &operator-=(difference_type offset)
+            {
+                return *this += -offset;
+            }
+
+            /**
+             * @brief Returns an iterator offset elements after this one.
+             * @param offset The number of elements to move by.
+             * @return The moved iterator.
+             */
+            AscendingIterator operator+(difference_type offset) const
+            {
+                AscendingIterator moved(*this);
+                moved += offset;
+                return moved;
+            }
+
+            /**
+             * @brief Returns an iterator offset elements before this one.
+             * @param offset The number of elements to move back by.
+             * @return The moved iterator.
+             */
+            AscendingIterator operator-(difference_type offset) const
+            {
+                AscendingIterator moved(*this);
+                moved -= offset;
+                return moved;
+            }
+
+            /**
+             * @brief Returns the distance between two iterators.
+             * @param other The iterator to measure from.
+             * @return The number of increments that lead from other to this iterator.
+             */
+            difference_type operator-(const AscendingIterator &other) const
+            {
+                return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+            }
+
+            friend AscendingIterator operator+(difference_type offset, const AscendingIterator &iterator)
+            {
+                return iterator + offset;
+            }
+
+            friend difference_type operator-(std::default_sentinel_t, const AscendingIterator &iterator)
+            {
+                return static_cast<difference_type>(iterator.endPosition() - iterator.position());
+            }
+
+            friend difference_type operator-(const AscendingIterator &iterator, std::default_sentinel_t)
+            {
+                return -static_cast<difference_type>(iterator.endPosition() - iterator.position());
+            }
+
             AscendingIterator begin();
             AscendingIterator end();
         };
@@ -78,36 +444,245 @@ namespace ariel
          * @brief An iterator that iterates over the elements in a side-cross pattern.
          *
          * The SideCrossIterator class provides an iterator that allows traversing the elements
-         * in a side-cross pattern in the MagicalContainer.
+         * in a side-cross pattern in the MagicalContainer. The k-th element of the pattern has a
+         * closed-form index in the sorted elements, so the iterator is random access.
          */
-        class SideCrossIterator : public Mystical_Iterator
+        class SideCrossIterator : public Mystical_Iterator_Base<SideCrossIterator>
         {
         private:
-            MagicalContainer *magic_ctr; /**< Pointer to the MagicalContainer object. */
-            std::size_t head_index;
-            std::size_t tail_index; /**< Index indicating the current position in the container. */
-            bool is_head;
+            friend class BasicMagicalContainer;
+
+            const BasicMagicalContainer *magic_ctr; /**< Pointer to the MagicalContainer object. */
+            std::size_t step;                 /**< Number of elements already visited in the side-cross order. */
+            [[no_unique_address]] VersionStamp stamp; /**< Container version at creation, see MAGICAL_CHECKED_ITERATORS. */
+
+            /**
+             * @brief Returns the element visited at a given step of the side-cross order.
+             * @param cross_step The step, from 0 to size() - 1.
+             * @return The element at that step.
+             *
+             * Even steps take the next element from the head, odd steps the next one from the tail.
+             */
+            typename Storage::const_reference elementAt(std::size_t cross_step) const
+            {
+                if (cross_step % 2 == 0)
+                {
+                    return magic_ctr->mystical_elements[cross_step / 2];
+                }
+                return magic_ctr->mystical_elements[magic_ctr->size() - 1 - cross_step / 2];
+            }
 
         public:
-            SideCrossIterator(MagicalContainer &magic_ctr);
-            SideCrossIterator(const SideCrossIterator &other);
-            SideCrossIterator(SideCrossIterator &&other) noexcept;
+            using iterator_category = LegacyCategory<std::random_access_iterator_tag>;
+            using iterator_concept = std::random_access_iterator_tag;
+            using value_type = typename Storage::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type *;
+            using reference = typename Storage::const_reference;
+
+            SideCrossIterator();
+            SideCrossIterator(const BasicMagicalContainer &magic_ctr);
+            /**
+             * @brief Copy constructor for SideCrossIterator.
+             * @param other The SideCrossIterator to copy from.
+             */
+            SideCrossIterator(const SideCrossIterator &other) : magic_ctr(other.magic_ctr), step(other.step), stamp(other.stamp) {}
+
+            /**
+             * @brief Move constructor for SideCrossIterator.
+             * @param other The other SideCrossIterator to move from.
+             */
+            SideCrossIterator(SideCrossIterator &&other) noexcept : magic_ctr(other.magic_ctr), step(other.step), stamp(other.stamp) {}
             /**
              * @brief Default Destructor for SideCrossIterator.
              */
-            ~SideCrossIterator() override = default;
+            ~SideCrossIterator() = default;
             SideCrossIterator &operator=(const SideCrossIterator &other);
             SideCrossIterator &operator=(SideCrossIterator &&other) noexcept;
-            bool operator==(const Mystical_Iterator &other) const override;
-            bool operator!=(const Mystical_Iterator &other) const override;
-            bool operator<(const Mystical_Iterator &other) const override;
-            bool operator>(const Mystical_Iterator &other) const override;
-            bool operator==(const SideCrossIterator &other) const;
-            bool operator!=(const SideCrossIterator &other) const;
-            bool operator>(const SideCrossIterator &other) const;
-            bool operator<(const SideCrossIterator &other) const;
-            int operator*() const;
-            SideCrossIterator &operator++();
+
+            /**
+             * @brief Returns the position of the iterator, used by the comparison operators.
+             * @return The number of elements already visited.
+             */
+            std::size_t position() const
+            {
+                return step;
+            }
+
+            /**
+             * @brief Returns the container the iterator walks over.
+             * @return Pointer to the container.
+             */
+            const BasicMagicalContainer *container() const
+            {
+                return magic_ctr;
+            }
+
+            /**
+             * @brief Returns the position of the end of the traversal, used to compare with std::default_sentinel.
+             * @return The number of elements in the container.
+             */
+            std::size_t endPosition() const
+            {
+                return magic_ctr->mystical_elements.size();
+            }
+
+            /**
+             * @brief Dereference operator.
+             * @return The element at the current position of the iterator.
+             * @throws std::runtime_error If the container was modified after the iterator was created (checked builds only).
+             */
+            reference operator*() const
+            {
+                stamp.check(magic_ctr->modifications);
+                return elementAt(step);
+            }
+
+            /**
+             * @brief Subscript operator.
+             * @param offset The offset from the current position.
+             * @return The element offset positions after the current one.
+             */
+            reference operator[](difference_type offset) const
+            {
+                stamp.check(magic_ctr->modifications);
+                return elementAt(static_cast<std::size_t>(static_cast<difference_type>(step) + offset));
+            }
+
+            /**
+             * @brief Pre-increment operator.
+             * @return Reference to the incremented iterator.
+             * @throws std::runtime_error If the iterator has reached the end.
+             */
+            SideCrossIterator &operator++()
+            {
+                stamp.check(magic_ctr->modifications);
+                if (step == magic_ctr->size())
+                {
+                    throw std::runtime_error("Reached to the end");
+                }
+                ++step;
+                return *this;
+            }
+
+            /**
+             * @brief Post-increment operator.
+             * @return A copy of the iterator before it was incremented.
+             * @throws std::runtime_error If the iterator has reached the end.
+             */
+            SideCrossIterator operator++(int)
+            {
+                SideCrossIterator previous(*this);
+                ++*this;
+                return previous;
+            }
+
+            /**
+             * @brief Pre-decrement operator.
+             * @return Reference to the decremented iterator.
+             * @throws std::runtime_error If the iterator is at the beginning.
+             */
+            SideCrossIterator &operator--()
+            {
+                stamp.check(magic_ctr->modifications);
+                if (step == 0)
+                {
+                    throw std::runtime_error("Cannot decrement the iterator past the beginning");
+                }
+                --step;
+                return *this;
+            }
+
+            /**
+             * @brief Post-decrement operator.
+             * @return A copy of the iterator before it was decremented.
+             * @throws std::runtime_error If the iterator is at the beginning.
+             */
+            SideCrossIterator operator--(int)
+            {
+                SideCrossIterator previous(*this);
+                --*this;
+                return previous;
+            }
+
+            /**
+             * @brief Moves the iterator by offset steps of the side-cross order in O(1).
+             * @param offset The number of elements to move by, negative to move backwards.
+             * @return Reference to the moved iterator.
+             * @throws std::runtime_error If the iterator would leave the range [begin, end].
+             */
+            SideCrossIterator &operator+=(difference_type offset)
+            {
+                stamp.check(magic_ctr->modifications);
+                auto target = static_cast<difference_type>(step) + offset;
+                if (target < 0 || target > static_cast<difference_type>(magic_ctr->size()))
+                {
+                    throw std::runtime_error("Invalid index");
+                }
+                step = static_cast<std::size_t>(target);
+                return *this;
+            }
+
+            /**
+             * @brief Moves the iterator backwards by offset elements.
+             * @param offset The number of elements to move back by.
+             * @return Reference to the moved iterator.
+             * @throws std::runtime_error If the iterator would leave the range [begin, end].
+             */
+            SideCrossIterator &operator-=(difference_type offset)
+            {
+                return *this += -offset;
+            }
+
+            /**
+             * @brief Returns an iterator offset elements after this one.
+             * @param offset The number of elements to move by.
+             * @return The moved iterator.
+             */
+            SideCrossIterator operator+(difference_type offset) const
+            {
+                SideCrossIterator moved(*this);
+                moved += offset;
+                return moved;
+            }
+
+            /**
+             * @brief Returns an iterator offset elements before this one.
+             * @param offset The number of elements to move back by.
+             * @return The moved iterator.
+             */
+            SideCrossIterator operator-(difference_type offset) const
+            {
+                SideCrossIterator moved(*this);
+                moved -= offset;
+                return moved;
+            }
+
+            /**
+             * @brief Returns the distance between two iterators.
+             * @param other The iterator to measure from.
+             * @return The number of increments that lead from other to this iterator.
+             */
+            difference_type operator-(const SideCrossIterator &other) const
+            {
+                return static_cast<difference_type>(step) - static_cast<difference_type>(other.step);
+            }
+
+            friend SideCrossIterator operator+(difference_type offset, const SideCrossIterator &iterator)
+            {
+                return iterator + offset;
+            }
+
+            friend difference_type operator-(std::default_sentinel_t, const SideCrossIterator &iterator)
+            {
+                return static_cast<difference_type>(iterator.endPosition() - iterator.position());
+            }
+
+            friend difference_type operator-(const SideCrossIterator &iterator, std::default_sentinel_t)
+            {
+                return -static_cast<difference_type>(iterator.endPosition() - iterator.position());
+            }
+
             SideCrossIterator begin();
             SideCrossIterator end();
         };
@@ -117,39 +692,264 @@ namespace ariel
          * @brief An iterator that iterates over the prime elements in the container.
          *
          * The PrimeIterator class provides an iterator that allows traversing the prime
-         * elements in the MagicalContainer.
+         * elements in the MagicalContainer. It walks the container's prime index, so no
+         * primality test is made while iterating and begin() / end() are O(1).
          */
-        class PrimeIterator : public Mystical_Iterator
+        class PrimeIterator : public Mystical_Iterator_Base<PrimeIterator>
         {
         private:
-            MagicalContainer *magic_ctr; /**< Pointer to the MagicalContainer object. */
-            std::size_t index;           /**< Index indicating the current position in the container. */
-            static bool isPrime(int value);
+            friend class BasicMagicalContainer;
+
+            const BasicMagicalContainer *magic_ctr; /**< Pointer to the MagicalContainer object. */
+            std::size_t index;           /**< Index indicating the current position among the prime elements. */
+            [[no_unique_address]] VersionStamp stamp; /**< Container version at creation, see MAGICAL_CHECKED_ITERATORS. */
 
         public:
-            PrimeIterator(MagicalContainer &magic_ctr);
-            PrimeIterator(const PrimeIterator &other);
-            PrimeIterator(PrimeIterator &&other) noexcept;
+            using iterator_category = LegacyCategory<std::bidirectional_iterator_tag>;
+            using iterator_concept = std::bidirectional_iterator_tag;
+            using value_type = typename Storage::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type *;
+            using reference = typename Storage::const_reference;
+
+            PrimeIterator();
+            PrimeIterator(const BasicMagicalContainer &magic_ctr)
+                requires has_primes;
+            /**
+             * @brief Copy constructor for PrimeIterator.
+             * @param other The PrimeIterator to copy from.
+             */
+            PrimeIterator(const PrimeIterator &other) : magic_ctr(other.magic_ctr), index(other.index), stamp(other.stamp) {}
+
+            /**
+             * @brief Move constructor for PrimeIterator.
+             * @param other The other PrimeIterator to move from.
+             */
+            PrimeIterator(PrimeIterator &&other) noexcept : magic_ctr(other.magic_ctr), index(other.index), stamp(other.stamp) {}
             /**
              * @brief Default Destructor for PrimeIterator.
              */
-            ~PrimeIterator() override = default;
+            ~PrimeIterator() = default;
             PrimeIterator &operator=(const PrimeIterator &other);
             PrimeIterator &operator=(PrimeIterator &&other) noexcept;
-            bool operator==(const Mystical_Iterator &other) const override;
-            bool operator!=(const Mystical_Iterator &other) const override;
-            bool operator<(const Mystical_Iterator &other) const override;
-            bool operator>(const Mystical_Iterator &other) const override;
-            bool operator==(const PrimeIterator &other) const;
-            bool operator!=(const PrimeIterator &other) const;
-            bool operator>(const PrimeIterator &other) const;
-            bool operator<(const PrimeIterator &other) const;
-            int operator*() const;
-            PrimeIterator &operator++();
+
+            /**
+             * @brief Returns the position of the iterator, used by the comparison operators.
+             * @return The index of the current element among the prime elements.
+             */
+            std::size_t position() const
+            {
+                return index;
+            }
+
+            /**
+             * @brief Returns the container the iterator walks over.
+             * @return Pointer to the container.
+             */
+            const BasicMagicalContainer *container() const
+            {
+                return magic_ctr;
+            }
+
+            /**
+             * @brief Returns the position of the end of the traversal, used to compare with std::default_sentinel.
+             * @return The number of prime elements in the container.
+             */
+            std::size_t endPosition() const
+            {
+                return magic_ctr->prime_elements.size();
+            }
+
+            /**
+             * @brief Dereference operator.
+             * @return The element at the current position of the iterator.
+             * @throws std::runtime_error If the container was modified after the iterator was created (checked builds only).
+             */
+            reference operator*() const
+            {
+                stamp.check(magic_ctr->modifications);
+                return magic_ctr->prime_elements[index];
+            }
+
+            /**
+             * @brief Pre-increment operator.
+             * @return Reference to the incremented iterator.
+             * @throws std::runtime_error If the iterator has reached the end.
+             */
+            PrimeIterator &operator++()
+            {
+                stamp.check(magic_ctr->modifications);
+                if (index == magic_ctr->prime_elements.size())
+                {
+                    throw std::runtime_error("Cannot increment while pointing at the end of the vector");
+                }
+                ++index;
+                return *this;
+            }
+
+            /**
+             * @brief Post-increment operator.
+             * @return A copy of the iterator before it was incremented.
+             * @throws std::runtime_error If the iterator has reached the end.
+             */
+            PrimeIterator operator++(int)
+            {
+                PrimeIterator previous(*this);
+                ++*this;
+                return previous;
+            }
+
+            /**
+             * @brief Pre-decrement operator.
+             * @return Reference to the decremented iterator.
+             * @throws std::runtime_error If the iterator is at the beginning.
+             */
+            PrimeIterator &operator--()
+            {
+                stamp.check(magic_ctr->modifications);
+                if (index == 0)
+                {
+                    throw std::runtime_error("Cannot decrement the iterator past the beginning");
+                }
+                --index;
+                return *this;
+            }
+
+            /**
+             * @brief Post-decrement operator.
+             * @return A copy of the iterator before it was decremented.
+             * @throws std::runtime_error If the iterator is at the beginning.
+             */
+            PrimeIterator operator--(int)
+            {
+                PrimeIterator previous(*this);
+                --*this;
+                return previous;
+            }
+
             PrimeIterator begin();
             PrimeIterator end();
         };
+
+        /**
+         * @brief A traversal of the container: an iterator and the sentinel ending it.
+         */
+        template <typename Iterator>
+        using Traversal = std::ranges::subrange<Iterator, std::default_sentinel_t>;
+
+        Traversal<AscendingIterator> ascending() const;
+        Traversal<SideCrossIterator> sideCross() const;
+        Traversal<PrimeIterator> primes() const
+            requires has_primes;
+
+        /**
+         * @brief A contiguous part of a traversal.
+         */
+        template <typename Iterator>
+        using Chunk = std::ranges::subrange<Iterator>;
+
+        AscendingIterator lowerBound(const value_type &value) const;
+        AscendingIterator upperBound(const value_type &value) const;
+        Chunk<AscendingIterator> equalRange(const value_type &value) const;
+        Chunk<AscendingIterator> ascending(const value_type &low, const value_type &high) const;
+        bool contains(const value_type &value) const;
+        std::size_t count(const value_type &value) const;
+
+        std::vector<Chunk<AscendingIterator>> ascendingChunks(std::size_t count) const;
+        std::vector<Chunk<SideCrossIterator>> sideCrossChunks(std::size_t count) const;
+        std::vector<Chunk<PrimeIterator>> primeChunks(std::size_t count) const
+            requires has_primes;
+
+        /**
+         * @brief Splits a traversal into balanced chunks and processes them on worker threads.
+         * @param order The traversal to split.
+         * @param function Callable invoked once per chunk with a Chunk of the matching iterator type
+         * (a generic lambda fits all orders). It runs concurrently and must be thread-safe.
+         * @param threads The most chunks and workers, 0 for one per hardware thread.
+         * @throws Any exception thrown by function, once every worker has finished.
+         *
+         * Every chunk holds at least min_chunk_elements elements, so small traversals use fewer
+         * workers, and the smallest run as one chunk on the calling thread without starting any.
+         * The container must not be modified while the traversal runs.
+         */
+        template <typename Function>
+        void parallelForEachChunk(TraversalOrder order, Function function, std::size_t threads = 0) const
+        {
+            switch (order)
+            {
+            case TraversalOrder::Ascending:
+                runInParallel(ascendingChunks(workerCount(threads, size())), function);
+                break;
+            case TraversalOrder::SideCross:
+                runInParallel(sideCrossChunks(workerCount(threads, size())), function);
+                break;
+            case TraversalOrder::Prime:
+                if constexpr (has_primes)
+                {
+                    runInParallel(primeChunks(workerCount(threads, prime_elements.size())), function);
+                }
+                else
+                {
+                    throw std::runtime_error("The prime traversal needs an integral element type");
+                }
+                break;
+            }
+        }
+
+        /**
+         * @brief Calls a function on every element of a traversal, using worker threads.
+         * @param order The traversal to run.
+         * @param function Callable invoked with each element. It runs concurrently and must be thread-safe.
+         * @param threads The most workers, 0 for one per hardware thread.
+         * @throws Any exception thrown by function, once every worker has finished.
+         *
+         * Each worker visits its own chunk in traversal order; chunks run in no particular order.
+         * Traversals too small to pay for a thread run on the calling thread, as in parallelForEachChunk().
+         */
+        template <typename Function>
+        void parallelForEach(TraversalOrder order, Function function, std::size_t threads = 0) const
+        {
+            parallelForEachChunk(
+                order, [&function](const auto &chunk) {
+                    for (const auto &element : chunk)
+                    {
+                        function(element);
+                    }
+                },
+                threads);
+        }
     };
+
+    /**
+     * @brief The MagicalContainer backed by a sorted vector.
+     */
+    using MagicalContainer = BasicMagicalContainer<SortedVectorStorage>;
+
+    /**
+     * @brief A MagicalContainer of any element type, backed by a sorted vector.
+     * @tparam T The element type, for instance std::int64_t, float or a struct with a key.
+     * @tparam Compare The strict weak ordering of the elements.
+     */
+    template <typename T, typename Compare = std::less<T>>
+    using MagicalContainerOf = BasicMagicalContainer<BasicSortedVectorStorage<T, Compare>>;
+
+    /**
+     * @brief A read-only MagicalContainer over a snapshot mapped into memory, opened with load().
+     *
+     * It supports every traversal and query of MagicalContainer directly on the mapped pages.
+     * Adding or removing elements does not compile.
+     * @tparam T The element type the snapshot was saved with.
+     * @tparam Compare The ordering the snapshot was saved with.
+     */
+    template <typename T = int, typename Compare = std::less<T>>
+    using MappedMagicalContainer = BasicMagicalContainer<MappedStorage<T, Compare>>;
+
+    extern template class BasicMagicalContainer<SortedVectorStorage>;
+    extern template class BasicMagicalContainer<BPlusTreeStorage>;
+    extern template class BasicMagicalContainer<EliasFanoStorage>;
+    extern template class BasicMagicalContainer<RoaringStorage>;
 } // namespace ariel
 
+#include "MagicalContainerImpl.hpp"
+
 #endif // CPP_EX4_PARTA_MAGICALCONTAINER_HPP
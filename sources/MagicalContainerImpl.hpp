@@ -0,0 +1,908 @@
+#ifndef CPP_EX4_PARTA_MAGICALCONTAINERIMPL_HPP
+#define CPP_EX4_PARTA_MAGICALCONTAINERIMPL_HPP
+
+/**
+ * @file MagicalContainerImpl.hpp
+ * @brief Member definitions of BasicMagicalContainer and its iterators.
+ *
+ * Included at the end of MagicalContainer.hpp so that containers of any element type can be
+ * instantiated. The int containers are explicitly instantiated once, in MagicalContainer.cpp.
+ */
+
+#include "MagicalContainer.hpp"
+
+namespace ariel
+{
+    /**
+     * @brief Constructs an empty MagicalContainer object.
+     */
+    template <typename Storage>
+    BasicMagicalContainer<Storage>::BasicMagicalContainer() {}
+
+    /**
+     * @brief Constructs a MagicalContainer that adopts an already sorted vector.
+     * @param sorted_elements The elements, in ascending order.
+     *
+     * The vector is moved into the container as is, without re-sorting it.
+     * @throws std::runtime_error If the elements are not in ascending order.
+     */
+    template <typename Storage>
+    BasicMagicalContainer<Storage>::BasicMagicalContainer(SortedRangeTag, std::vector<value_type> sorted_elements)
+    {
+        if (!std::is_sorted(sorted_elements.begin(), sorted_elements.end(), value_compare()))
+        {
+            throw std::runtime_error("The elements are not sorted");
+        }
+        if constexpr (has_primes)
+        {
+            prime_elements = Storage(primesOf(sorted_elements));
+        }
+        mystical_elements = Storage(std::move(sorted_elements));
+    }
+
+    /**
+     * @brief Adds an element to the container.
+     * @param element The element to be added.
+     */
+    template <typename Storage>
+    void BasicMagicalContainer<Storage>::addElement(const value_type &element)
+    {
+        mystical_elements.insert(element);
+        if constexpr (has_primes)
+        {
+            if (isPrime(element))
+            {
+                prime_elements.insert(element);
+            }
+        }
+        modifications.bump();
+    }
+
+    /**
+     * @brief Adds all the given elements to the container.
+     * @param elements The elements to be added.
+     */
+    template <typename Storage>
+    void BasicMagicalContainer<Storage>::addElements(std::span<const value_type> elements)
+    {
+        addElements(elements.begin(), elements.end());
+    }
+
+    /**
+     * @brief Adds all the given elements to the container.
+     * @param elements The elements to be added.
+     */
+    template <typename Storage>
+    void BasicMagicalContainer<Storage>::addElements(std::initializer_list<value_type> elements)
+    {
+        addElements(elements.begin(), elements.end());
+    }
+
+    /**
+     * @brief Removes an element from the container.
+     * @param element The element to be removed.
+     *
+     * If the element exists in the container, it will be removed. If there are multiple
+     * occurrences of the element, only the first occurrence will be removed.
+     * @throws std::runtime_error If the element is not found in the container.
+     */
+    template <typename Storage>
+    void BasicMagicalContainer<Storage>::removeElement(const value_type &element)
+    {
+        // The storage is sorted, so the element is found with a binary search
+        if (!mystical_elements.erase(element))
+        {
+            throw std::runtime_error("The number is not in the container");
+        }
+        if constexpr (has_primes)
+        {
+            if (isPrime(element))
+            {
+                prime_elements.erase(element);
+            }
+        }
+        modifications.bump();
+    }
+
+    /**
+     * @brief Removes all the given elements from the container.
+     * @param elements The elements to be removed.
+     *
+     * Every value removes a single occurrence, so a value listed twice removes two occurrences.
+     * The removal is done in one pass over the storage instead of one shift per element.
+     * @throws std::runtime_error If one of the elements is not in the container. The container is left unchanged.
+     */
+    template <typename Storage>
+    void BasicMagicalContainer<Storage>::removeElements(std::span<const value_type> elements)
+    {
+        std::vector<value_type> to_remove(elements.begin(), elements.end());
+        std::sort(to_remove.begin(), to_remove.end(), value_compare());
+
+        // Every distinct value must be stored at least as many times as it is listed
+        for (auto run = to_remove.begin(); run != to_remove.end();)
+        {
+            auto run_end = std::upper_bound(run, to_remove.end(), *run, value_compare());
+            auto stored = mystical_elements.upperBound(*run) - mystical_elements.lowerBound(*run);
+            if (stored < static_cast<std::size_t>(run_end - run))
+            {
+                throw std::runtime_error("The number is not in the container");
+            }
+            run = run_end;
+        }
+
+        mystical_elements.eraseSorted(to_remove);
+        if constexpr (has_primes)
+        {
+            prime_elements.eraseSorted(primesOf(to_remove));
+        }
+        modifications.bump();
+    }
+
+    /**
+     * @brief Removes all the given elements from the container.
+     * @param elements The elements to be removed.
+     * @throws std::runtime_error If one of the elements is not in the container.
+     */
+    template <typename Storage>
+    void BasicMagicalContainer<Storage>::removeElements(std::initializer_list<value_type> elements)
+    {
+        removeElements(std::span<const value_type>(elements.begin(), elements.size()));
+    }
+
+    /**
+     * @brief Returns the prime values of a sorted sequence.
+     * @param sorted_values The values, in ascending order.
+     * @return The prime values, still in ascending order.
+     *
+     * Without the shared PrimeSieve a batch of int goes through the vectorized
+     * primality::filterPrimes screen instead of one isPrime() call per value.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::primesOf(std::span<const value_type> sorted_values) -> std::vector<value_type>
+    {
+        if constexpr (std::is_same_v<value_type, int>)
+        {
+            if (!PrimeSieve::enabled())
+            {
+                return primality::filterPrimes(sorted_values);
+            }
+        }
+        std::vector<value_type> primes;
+        std::copy_if(sorted_values.begin(), sorted_values.end(), std::back_inserter(primes), isPrime);
+        return primes;
+    }
+
+    /**
+     * @brief Views the elements of a storage as one sorted array.
+     * @param storage The storage to view.
+     * @param buffer Receives a copy of the elements when the storage is not contiguous.
+     * @return The elements in ascending order, valid while storage and buffer are unchanged.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::sortedSpan(const Storage &storage, std::vector<value_type> &buffer) -> std::span<const value_type>
+    {
+        if constexpr (Storage::is_contiguous)
+        {
+            return {storage.data(), storage.size()};
+        }
+        else
+        {
+            buffer.clear();
+            buffer.reserve(storage.size());
+            for (std::size_t rank = 0; rank < storage.size(); ++rank)
+            {
+                buffer.push_back(storage[rank]);
+            }
+            return buffer;
+        }
+    }
+
+    /**
+     * @brief Returns the sum of the elements.
+     * @return The sum, accumulated in 64 bits (see sum_type).
+     *
+     * Contiguous int storages are summed by the widest SIMD kernel the CPU supports (see
+     * aggregates::sum), everything else by walking the ascending traversal.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::sum() const -> sum_type
+        requires std::is_arithmetic_v<value_type>
+    {
+        if constexpr (Storage::is_contiguous && std::is_same_v<value_type, int>)
+        {
+            return aggregates::sum(std::span<const int>(mystical_elements.data(), mystical_elements.size()));
+        }
+        else
+        {
+            sum_type total = 0;
+            for (const value_type &element : ascending())
+            {
+                total += static_cast<sum_type>(element);
+            }
+            return total;
+        }
+    }
+
+    /**
+     * @brief Returns the first element under value_compare.
+     * @return The first element of the ascending traversal: the smallest one for the default
+     * std::less, but the largest one for a container ordered by std::greater.
+     * @throws std::runtime_error If the container is empty.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::min() const -> value_type
+    {
+        if (mystical_elements.size() == 0)
+        {
+            throw std::runtime_error("The container is empty");
+        }
+        return mystical_elements[0];
+    }
+
+    /**
+     * @brief Returns the last element under value_compare.
+     * @return The last element of the ascending traversal: the largest one for the default
+     * std::less, but the smallest one for a container ordered by std::greater.
+     * @throws std::runtime_error If the container is empty.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::max() const -> value_type
+    {
+        if (mystical_elements.size() == 0)
+        {
+            throw std::runtime_error("The container is empty");
+        }
+        return mystical_elements[mystical_elements.size() - 1];
+    }
+
+    /**
+     * @brief Counts the elements in a half-open range of values.
+     * @param low The smallest value counted.
+     * @param high The first value past the range.
+     * @return The number of elements e with low <= e < high, 0 if the range is empty.
+     *
+     * The elements are sorted, so this is two binary searches rather than a scan.
+     */
+    template <typename Storage>
+    std::size_t BasicMagicalContainer<Storage>::countInRange(const value_type &low, const value_type &high) const
+    {
+        if (!value_compare()(low, high))
+        {
+            return 0;
+        }
+        return mystical_elements.lowerBound(high) - mystical_elements.lowerBound(low);
+    }
+
+    /**
+     * @brief Counts the elements falling in equal-width buckets of a value range.
+     * @param low The smallest value of the first bucket.
+     * @param high The first value past the last bucket.
+     * @param buckets The number of buckets.
+     * @return The count of every bucket. Elements outside [low, high) are not counted.
+     * @throws std::runtime_error If the range is empty or buckets is 0.
+     *
+     * Bucket i covers [low + (high - low) * i / buckets, low + (high - low) * (i + 1) / buckets),
+     * rounded down for integral elements. Each bucket edge is located with one binary search, so
+     * the cost does not depend on size(). The edges grow from low to high, so the elements must
+     * be stored in ascending order: the function only exists for std::less.
+     */
+    template <typename Storage>
+    std::vector<std::size_t> BasicMagicalContainer<Storage>::histogram(value_type low, value_type high, std::size_t buckets) const
+        requires std::is_arithmetic_v<value_type> && std::same_as<value_compare, std::less<value_type>>
+    {
+        if (!(low < high) || buckets == 0)
+        {
+            throw std::runtime_error("Invalid histogram range");
+        }
+
+        std::vector<std::size_t> counts(buckets);
+        std::size_t previous = mystical_elements.lowerBound(low);
+        for (std::size_t bucket = 0; bucket < buckets; ++bucket)
+        {
+            value_type edge = high;
+            if constexpr (std::is_integral_v<value_type>)
+            {
+                // Unsigned 64-bit arithmetic wraps correctly for negative bounds and cannot overflow
+                auto width = static_cast<std::uint64_t>(high) - static_cast<std::uint64_t>(low);
+                auto step = static_cast<std::uint64_t>(bucket + 1);
+                std::uint64_t offset = width / buckets * step + width % buckets * step / buckets;
+                edge = static_cast<value_type>(static_cast<std::uint64_t>(low) + offset);
+            }
+            else if (bucket + 1 < buckets)
+            {
+                edge = low + (high - low) * static_cast<value_type>(bucket + 1) / static_cast<value_type>(buckets);
+            }
+            std::size_t next = mystical_elements.lowerBound(edge);
+            counts[bucket] = next - previous;
+            previous = next;
+        }
+        return counts;
+    }
+
+    /**
+     * @brief Builds a container by applying a set operation to the elements and to the primes.
+     * @param other The right operand.
+     * @param operation Maps two sorted spans to the sorted vector of the result.
+     * @return The new container.
+     *
+     * A value is prime on one side exactly when it is prime on the other, so applying the same
+     * operation to both prime indexes yields the prime index of the result without testing a
+     * single value.
+     */
+    template <typename Storage>
+    template <typename Operation>
+    auto BasicMagicalContainer<Storage>::combine(const BasicMagicalContainer &other, Operation operation) const -> BasicMagicalContainer
+    {
+        std::vector<value_type> lhs_buffer;
+        std::vector<value_type> rhs_buffer;
+        BasicMagicalContainer result;
+        result.mystical_elements = Storage(operation(sortedSpan(mystical_elements, lhs_buffer), sortedSpan(other.mystical_elements, rhs_buffer)));
+        if constexpr (has_primes)
+        {
+            result.prime_elements = Storage(operation(sortedSpan(prime_elements, lhs_buffer), sortedSpan(other.prime_elements, rhs_buffer)));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the elements present in both containers.
+     * @param other The container to intersect with.
+     * @return A new container holding min(a, b) copies of a value stored a times here and b times in other.
+     *
+     * Both sorted arrays are walked once, or the smaller one gallops through the larger when
+     * their sizes differ widely; int elements use SIMD block comparisons (see setalgebra).
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::intersect(const BasicMagicalContainer &other) const -> BasicMagicalContainer
+    {
+        return combine(other, [](std::span<const value_type> lhs, std::span<const value_type> rhs) {
+            return setalgebra::intersect(lhs, rhs, value_compare());
+        });
+    }
+
+    /**
+     * @brief Returns the elements present in either container.
+     * @param other The container to unite with.
+     * @return A new container holding max(a, b) copies of a value stored a times here and b times in other.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::unite(const BasicMagicalContainer &other) const -> BasicMagicalContainer
+    {
+        return combine(other, [](std::span<const value_type> lhs, std::span<const value_type> rhs) {
+            return setalgebra::unite(lhs, rhs, value_compare());
+        });
+    }
+
+    /**
+     * @brief Returns the elements of this container not matched in another.
+     * @param other The container to subtract.
+     * @return A new container holding max(a - b, 0) copies of a value stored a times here and b times in other.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::subtract(const BasicMagicalContainer &other) const -> BasicMagicalContainer
+    {
+        return combine(other, [](std::span<const value_type> lhs, std::span<const value_type> rhs) {
+            return setalgebra::subtract(lhs, rhs, value_compare());
+        });
+    }
+
+    /**
+     * @brief Writes the container to a snapshot file.
+     * @param path The file to create or overwrite.
+     * @throws std::runtime_error If the file cannot be written.
+     *
+     * The snapshot holds the sorted elements and, for integral elements, the prime index, so
+     * load() neither sorts nor tests primality. See snapshot::Header for the format.
+     */
+    template <typename Storage>
+    void BasicMagicalContainer<Storage>::save(const std::string &path) const
+        requires std::is_trivially_copyable_v<value_type>
+    {
+        std::vector<value_type> element_buffer;
+        std::vector<value_type> prime_buffer;
+        std::span<const value_type> elements = sortedSpan(mystical_elements, element_buffer);
+        std::span<const value_type> primes = sortedSpan(prime_elements, prime_buffer);
+        snapshot::write(path, snapshot::elementType<value_type, value_compare>(), elements.data(), elements.size(), primes.data(), primes.size(), has_primes);
+    }
+
+    /**
+     * @brief Reads a container back from a snapshot file written by save().
+     * @param path The snapshot file.
+     * @return The container.
+     * @throws std::runtime_error If the file cannot be read, was written for another element type,
+     * byte order or format version, or fails its checksum.
+     *
+     * The arrays are read sequentially and adopted as they are. A storage that can map a
+     * snapshot, such as MappedStorage, maps the file instead and reads nothing up front.
+     */
+    template <typename Storage>
+    BasicMagicalContainer<Storage> BasicMagicalContainer<Storage>::load(const std::string &path)
+        requires std::is_trivially_copyable_v<value_type>
+    {
+        if constexpr (requires { Storage::openSnapshot(path, has_primes); })
+        {
+            auto [elements, primes] = Storage::openSnapshot(path, has_primes);
+            BasicMagicalContainer container;
+            container.mystical_elements = std::move(elements);
+            container.prime_elements = std::move(primes);
+            return container;
+        }
+        else
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (!in)
+            {
+                throw std::runtime_error("Cannot open the snapshot " + path);
+            }
+            snapshot::Header header = snapshot::readHeader(in, snapshot::elementType<value_type, value_compare>());
+            if (((header.flags & snapshot::has_prime_index) != 0) != has_primes)
+            {
+                throw std::runtime_error("The snapshot holds elements of another type");
+            }
+
+            snapshot::Checksum checksum;
+            std::vector<value_type> elements(static_cast<std::size_t>(header.element_count));
+            snapshot::readArray(in, elements.data(), header.element_count * sizeof(value_type), header.elements_offset, checksum);
+            std::vector<value_type> primes(static_cast<std::size_t>(header.prime_count));
+            snapshot::readArray(in, primes.data(), header.prime_count * sizeof(value_type), header.primes_offset, checksum);
+            snapshot::verify(header, checksum);
+
+            BasicMagicalContainer container;
+            container.mystical_elements = Storage(std::move(elements));
+            if constexpr (has_primes)
+            {
+                container.prime_elements = Storage(std::move(primes));
+            }
+            return container;
+        }
+    }
+
+    /**
+     * @brief Returns the ascending traversal of the container.
+     * @return The AscendingIterator at the first element, ended by std::default_sentinel.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::ascending() const -> Traversal<AscendingIterator>
+    {
+        return {AscendingIterator(*this), std::default_sentinel};
+    }
+
+    /**
+     * @brief Returns the side-cross traversal of the container.
+     * @return The SideCrossIterator at the first element, ended by std::default_sentinel.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::sideCross() const -> Traversal<SideCrossIterator>
+    {
+        return {SideCrossIterator(*this), std::default_sentinel};
+    }
+
+    /**
+     * @brief Returns the traversal of the prime elements of the container.
+     * @return The PrimeIterator at the first prime element, ended by std::default_sentinel.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::primes() const -> Traversal<PrimeIterator>
+        requires has_primes
+    {
+        return {PrimeIterator(*this), std::default_sentinel};
+    }
+
+    /**
+     * @brief Returns an iterator at the first element not less than a value.
+     * @param value The value to look for.
+     * @return The AscendingIterator at that element, or at the end if every element is less than value.
+     *
+     * The elements are sorted, so this is a binary search.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::lowerBound(const value_type &value) const -> AscendingIterator
+    {
+        return AscendingIterator(*this, value);
+    }
+
+    /**
+     * @brief Returns an iterator at the first element greater than a value.
+     * @param value The value to look for.
+     * @return The AscendingIterator at that element, or at the end if no element is greater than value.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::upperBound(const value_type &value) const -> AscendingIterator
+    {
+        AscendingIterator iter(*this);
+        iter.index = mystical_elements.upperBound(value);
+        return iter;
+    }
+
+    /**
+     * @brief Returns the elements equal to a value.
+     * @param value The value to look for.
+     * @return The part of the ascending traversal holding every occurrence of value, empty if there is none.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::equalRange(const value_type &value) const -> Chunk<AscendingIterator>
+    {
+        return {lowerBound(value), upperBound(value)};
+    }
+
+    /**
+     * @brief Returns the elements in a half-open range of values.
+     * @param low The smallest value included.
+     * @param high The first value past the range.
+     * @return The part of the ascending traversal holding every element e with low <= e < high.
+     *
+     * Only the two ends are searched, so iterating [low, high) costs O(log N) plus the elements visited.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::ascending(const value_type &low, const value_type &high) const -> Chunk<AscendingIterator>
+    {
+        AscendingIterator first = lowerBound(low);
+        AscendingIterator last = lowerBound(high);
+        if (last.index < first.index)
+        {
+            last = first;
+        }
+        return {first, last};
+    }
+
+    /**
+     * @brief Checks if a value is in the container.
+     * @param value The value to look for.
+     * @return True if at least one element equals value.
+     */
+    template <typename Storage>
+    bool BasicMagicalContainer<Storage>::contains(const value_type &value) const
+    {
+        std::size_t rank = mystical_elements.lowerBound(value);
+        return rank < mystical_elements.size() && !value_compare()(value, mystical_elements[rank]);
+    }
+
+    /**
+     * @brief Counts the occurrences of a value.
+     * @param value The value to look for.
+     * @return The number of elements equal to value.
+     */
+    template <typename Storage>
+    std::size_t BasicMagicalContainer<Storage>::count(const value_type &value) const
+    {
+        return mystical_elements.upperBound(value) - mystical_elements.lowerBound(value);
+    }
+
+    /**
+     * @brief Splits the ascending traversal into balanced chunks.
+     * @param count The requested number of chunks.
+     * @return At most count non-empty chunks of (almost) equal size, in traversal order.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::ascendingChunks(std::size_t count) const -> std::vector<Chunk<AscendingIterator>>
+    {
+        std::vector<Chunk<AscendingIterator>> chunks;
+        std::vector<std::size_t> boundaries = chunkBoundaries(size(), count);
+        for (std::size_t chunk = 0; chunk + 1 < boundaries.size() && boundaries.back() > 0; ++chunk)
+        {
+            AscendingIterator first(*this);
+            AscendingIterator last(*this);
+            first.index = boundaries[chunk];
+            last.index = boundaries[chunk + 1];
+            chunks.emplace_back(first, last);
+        }
+        return chunks;
+    }
+
+    /**
+     * @brief Splits the side-cross traversal into balanced chunks.
+     * @param count The requested number of chunks.
+     * @return At most count non-empty chunks of (almost) equal size, in traversal order.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::sideCrossChunks(std::size_t count) const -> std::vector<Chunk<SideCrossIterator>>
+    {
+        std::vector<Chunk<SideCrossIterator>> chunks;
+        std::vector<std::size_t> boundaries = chunkBoundaries(size(), count);
+        for (std::size_t chunk = 0; chunk + 1 < boundaries.size() && boundaries.back() > 0; ++chunk)
+        {
+            SideCrossIterator first(*this);
+            SideCrossIterator last(*this);
+            first.step = boundaries[chunk];
+            last.step = boundaries[chunk + 1];
+            chunks.emplace_back(first, last);
+        }
+        return chunks;
+    }
+
+    /**
+     * @brief Splits the prime traversal into chunks holding the same number of primes.
+     * @param count The requested number of chunks.
+     * @return At most count non-empty chunks, in traversal order.
+     *
+     * The split is made over the prime index, so every worker gets the same number of primes
+     * no matter how they are spread over the container.
+     */
+    template <typename Storage>
+    auto BasicMagicalContainer<Storage>::primeChunks(std::size_t count) const -> std::vector<Chunk<PrimeIterator>>
+        requires has_primes
+    {
+        std::vector<Chunk<PrimeIterator>> chunks;
+        std::vector<std::size_t> boundaries = chunkBoundaries(prime_elements.size(), count);
+        for (std::size_t chunk = 0; chunk + 1 < boundaries.size() && boundaries.back() > 0; ++chunk)
+        {
+            PrimeIterator first(*this);
+            PrimeIterator last(*this);
+            first.index = boundaries[chunk];
+            last.index = boundaries[chunk + 1];
+            chunks.emplace_back(first, last);
+        }
+        return chunks;
+    }
+
+    /**
+     * @brief Constructs an AscendingIterator that is not attached to any container.
+     *
+     * Such an iterator can only be assigned to or destroyed.
+     */
+    template <typename Storage>
+    BasicMagicalContainer<Storage>::AscendingIterator::AscendingIterator() : magic_ctr(nullptr), index(0), stamp() {}
+
+    /**
+     * @brief Constructs an AscendingIterator object.
+     * @param magic_ctr The MagicalContainer to iterate over.
+     */
+    template <typename Storage>
+    BasicMagicalContainer<Storage>::AscendingIterator::AscendingIterator(const BasicMagicalContainer &magic_ctr) : magic_ctr(&magic_ctr), index(0), stamp(magic_ctr.modifications) {}
+
+    /**
+     * @brief Constructs an AscendingIterator starting at a given value.
+     * @param magic_ctr The MagicalContainer to iterate over.
+     * @param start_value The iterator starts at the first element not less than this value.
+     *
+     * The start is found with a binary search, so no element before it is visited.
+     */
+    template <typename Storage>
+    BasicMagicalContainer<Storage>::AscendingIterator::AscendingIterator(const BasicMagicalContainer &magic_ctr, const value_type &start_value) : magic_ctr(&magic_ctr), index(magic_ctr.mystical_elements.lowerBound(start_value)), stamp(magic_ctr.modifications) {}
+
+    /**
+     * @brief Move assignment operator for AscendingIterator.
+     * @param other The other AscendingIterator to move from.
+     * @return Reference to the assigned AscendingIterator.
+     */
+    template <typename Storage>
+    typename BasicMagicalContainer<Storage>::AscendingIterator &BasicMagicalContainer<Storage>::AscendingIterator::operator=(AscendingIterator &&other) noexcept {
+        if (this != &other)
+        {
+            magic_ctr = other.magic_ctr;
+            index = other.index;
+            stamp = other.stamp;
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Assignment operator for AscendingIterator.
+     * @param other The AscendingIterator to assign from.
+     * @return Reference to the assigned AscendingIterator.
+     * @throws std::runtime_error If the iterators are pointing at different containers.
+     */
+    template <typename Storage>
+    typename BasicMagicalContainer<Storage>::AscendingIterator &BasicMagicalContainer<Storage>::AscendingIterator::operator=(const AscendingIterator &other)
+    {
+        if (this->magic_ctr != nullptr && this->magic_ctr != other.magic_ctr)
+        {
+            throw std::runtime_error("Iterators are pointing at different containers");
+        }
+
+        if (this != &other)
+        {
+            magic_ctr = other.magic_ctr;
+            index = other.index;
+            stamp = other.stamp;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Returns the beginning iterator of the container.
+     * @return The beginning iterator.
+     */
+    template <typename Storage>
+    typename BasicMagicalContainer<Storage>::AscendingIterator BasicMagicalContainer<Storage>::AscendingIterator::begin()
+    {
+        return AscendingIterator(*magic_ctr);
+    }
+
+    /**
+     * @brief Returns the ending iterator of the container.
+     * @return The ending iterator.
+     */
+    template <typename Storage>
+    typename BasicMagicalContainer<Storage>::AscendingIterator BasicMagicalContainer<Storage>::AscendingIterator::end()
+    {
+        AscendingIterator iter(*magic_ctr);
+        iter.index = magic_ctr->size();
+        return iter;
+    }
+
+    /**
+     * @brief Constructs a SideCrossIterator that is not attached to any container.
+     *
+     * Such an iterator can only be assigned to or destroyed.
+     */
+    template <typename Storage>
+    BasicMagicalContainer<Storage>::SideCrossIterator::SideCrossIterator() : magic_ctr(nullptr), step(0), stamp() {}
+
+    /**
+     * @brief Constructs a SideCrossIterator object.
+     * @param magic_ctr The MagicalContainer to iterate over.
+     */
+    template <typename Storage>
+    BasicMagicalContainer<Storage>::SideCrossIterator::SideCrossIterator(const BasicMagicalContainer &magic_ctr) : magic_ctr(&magic_ctr), step(0), stamp(magic_ctr.modifications) {}
+
+    /**
+     * @brief Move assignment operator for SideCrossIterator.
+     * @param other The other SideCrossIterator to move from.
+     * @return Reference to the assigned SideCrossIterator.
+     */
+    template <typename Storage>
+    typename BasicMagicalContainer<Storage>::SideCrossIterator &BasicMagicalContainer<Storage>::SideCrossIterator::operator=(SideCrossIterator &&other) noexcept {
+        if (this != &other)
+        {
+            magic_ctr = other.magic_ctr;
+            step = other.step;
+            stamp = other.stamp;
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Assignment operator for SideCrossIterator.
+     * @param other The SideCrossIterator to assign from.
+     * @return Reference to the assigned SideCrossIterator.
+     * @throws std::runtime_error If the iterators are pointing at different containers.
+     */
+    template <typename Storage>
+    typename BasicMagicalContainer<Storage>::SideCrossIterator &BasicMagicalContainer<Storage>::SideCrossIterator::operator=(const SideCrossIterator &other)
+    {
+        if (this->magic_ctr != nullptr && this->magic_ctr != other.magic_ctr)
+        {
+            throw std::runtime_error("Iterators are pointing at different containers");
+        }
+        if (this != &other)
+        {
+            magic_ctr = other.magic_ctr;
+            step = other.step;
+            stamp = other.stamp;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Returns the beginning iterator of the container.
+     * @return The beginning iterator.
+     */
+    template <typename Storage>
+    typename BasicMagicalContainer<Storage>::SideCrossIterator BasicMagicalContainer<Storage>::SideCrossIterator::begin()
+    {
+        return SideCrossIterator(*magic_ctr);
+    }
+
+    /**
+     * @brief Returns the ending iterator of the container.
+     * @return The ending iterator.
+     */
+    template <typename Storage>
+    typename BasicMagicalContainer<Storage>::SideCrossIterator BasicMagicalContainer<Storage>::SideCrossIterator::end()
+    {
+        SideCrossIterator iter(*magic_ctr);
+        iter.step = magic_ctr->size();
+        return iter;
+    }
+
+    /**
+     * @brief Constructs a PrimeIterator that is not attached to any container.
+     *
+     * Such an iterator can only be assigned to or destroyed.
+     */
+    template <typename Storage>
+    BasicMagicalContainer<Storage>::PrimeIterator::PrimeIterator() : magic_ctr(nullptr), index(0), stamp() {}
+
+    /**
+     * @brief Constructs a PrimeIterator object.
+     * @param magic_ctr The MagicalContainer to iterate over.
+     */
+
+    template <typename Storage>
+    BasicMagicalContainer<Storage>::PrimeIterator::PrimeIterator(const BasicMagicalContainer &magic_ctr)
+        requires(has_primes)
+        : magic_ctr(&magic_ctr), index(0), stamp(magic_ctr.modifications) {}
+
+    /**
+     * @brief Move assignment operator for PrimeIterator.
+     * @param other The other PrimeIterator to move from.
+     * @return Reference to the assigned PrimeIterator.
+     */
+    template <typename Storage>
+    typename BasicMagicalContainer<Storage>::PrimeIterator &BasicMagicalContainer<Storage>::PrimeIterator::operator=(PrimeIterator &&other) noexcept {
+        if (this != &other)
+        {
+            magic_ctr = other.magic_ctr;
+            index = other.index;
+            stamp = other.stamp;
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Assignment operator for PrimeIterator.
+     * @param other The PrimeIterator to assign from.
+     * @return Reference to the assigned PrimeIterator.
+     * @throws std::runtime_error If the iterators are pointing at different containers.
+     */
+    template <typename Storage>
+    typename BasicMagicalContainer<Storage>::PrimeIterator &BasicMagicalContainer<Storage>::PrimeIterator::operator=(const PrimeIterator &other)
+    {
+        if (this->magic_ctr != nullptr && this->magic_ctr != other.magic_ctr)
+        {
+            throw std::runtime_error("Iterators are pointing at different containers");
+        }
+
+        if (this != &other)
+        {
+            magic_ctr = other.magic_ctr;
+            index = other.index;
+            stamp = other.stamp;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Returns the beginning iterator of the container.
+     * @return The beginning iterator.
+     */
+    template <typename Storage>
+    typename BasicMagicalContainer<Storage>::PrimeIterator BasicMagicalContainer<Storage>::PrimeIterator::begin()
+    {
+        return PrimeIterator(*magic_ctr);
+    }
+
+    /**
+     * @brief Returns the ending iterator of the container.
+     * @return The ending iterator.
+     */
+    template <typename Storage>
+    typename BasicMagicalContainer<Storage>::PrimeIterator BasicMagicalContainer<Storage>::PrimeIterator::end()
+    {
+        PrimeIterator iter(*magic_ctr);
+        iter.index = magic_ctr->prime_elements.size();
+        return iter;
+    }
+    /**
+     * @brief Checks if a given value is prime.
+     * @param value The value to check for primality.
+     * @return True if the value is prime, false otherwise.
+     *
+     * Values inside the shared PrimeSieve (when enabled) are answered from its bitmap, other
+     * values that fit in an int by primality::isPrime and wider ones by primality::isPrimeWide.
+     */
+    template <typename Storage>
+    bool BasicMagicalContainer<Storage>::isPrime(value_type value)
+    {
+        if (std::cmp_less(value, 2))
+        {
+            return false;
+        }
+        if (std::cmp_less_equal(value, std::numeric_limits<int>::max()))
+        {
+            auto narrow = static_cast<int>(value);
+            if (std::optional<bool> known = PrimeSieve::lookup(narrow))
+            {
+                return *known;
+            }
+            return primality::isPrime(narrow);
+        }
+        return primality::isPrimeWide(static_cast<std::uint64_t>(value));
+    }
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_MAGICALCONTAINERIMPL_HPP
@@ -0,0 +1,54 @@
+#include "MappedStorage.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace ariel;
+
+/**
+ * @brief Maps a whole file read-only.
+ * @param path The file to map.
+ * @throws std::runtime_error If the file cannot be opened or mapped.
+ */
+MappedFile::MappedFile(const std::string &path)
+{
+    int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0)
+    {
+        throw std::runtime_error("Cannot open the snapshot " + path);
+    }
+
+    struct stat status
+    {
+    };
+    if (::fstat(descriptor, &status) != 0)
+    {
+        ::close(descriptor);
+        throw std::runtime_error("Cannot open the snapshot " + path);
+    }
+    length = static_cast<std::size_t>(status.st_size);
+
+    if (length > 0)
+    {
+        void *mapping = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, descriptor, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(descriptor);
+            throw std::runtime_error("Cannot map the snapshot " + path);
+        }
+        address = mapping;
+    }
+    // The mapping keeps the file alive on its own
+    ::close(descriptor);
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+MappedFile::~MappedFile()
+{
+    if (address != nullptr)
+    {
+        ::munmap(const_cast<void *>(address), length);
+    }
+}
@@ -0,0 +1,179 @@
+#ifndef CPP_EX4_PARTA_MAPPEDSTORAGE_HPP
+#define CPP_EX4_PARTA_MAPPEDSTORAGE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "Snapshot.hpp"
+
+namespace ariel
+{
+    /**
+     * @class MappedFile
+     * @brief A whole file mapped read-only into memory, unmapped on destruction.
+     *
+     * The pages are shared with the page cache, so every process mapping the same file reads
+     * the same physical memory and nothing is copied into the process heap.
+     */
+    class MappedFile
+    {
+    private:
+        const void *address = nullptr; /**< Start of the mapping, null for an empty file. */
+        std::size_t length = 0;        /**< Size of the file and of the mapping. */
+
+    public:
+        explicit MappedFile(const std::string &path);
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        ~MappedFile();
+
+        /**
+         * @brief Returns the first byte of the file.
+         * @return Pointer to the mapped bytes.
+         */
+        const std::byte *data() const
+        {
+            return static_cast<const std::byte *>(address);
+        }
+
+        /**
+         * @brief Returns the size of the file.
+         * @return The number of mapped bytes.
+         */
+        std::size_t size() const
+        {
+            return length;
+        }
+    };
+
+    /**
+     * @class MappedStorage
+     * @brief Read-only storage policy reading the sorted elements straight from a mapped snapshot.
+     *
+     * It provides the read half of the storage interface only (size(), operator[], data(),
+     * lowerBound(), upperBound()), so a container using it can be traversed and queried with
+     * every iterator while any attempt to modify it fails to compile. The storages opened from
+     * one snapshot share its mapping, which stays alive as long as any copy of them does.
+     *
+     * @tparam T The element type, which must match the type the snapshot was saved with.
+     * @tparam Compare The ordering the snapshot was saved with.
+     */
+    template <typename T, typename Compare = std::less<T>>
+    class MappedStorage
+    {
+    private:
+        std::shared_ptr<const MappedFile> file; /**< The mapping the elements live in. */
+        const T *elements = nullptr;           /**< The elements, in ascending order, inside the mapping. */
+        std::size_t count = 0;                 /**< The number of elements. */
+        [[no_unique_address]] Compare compare; /**< The ordering of the elements. */
+
+        MappedStorage(std::shared_ptr<const MappedFile> file, std::uint64_t offset, std::uint64_t count)
+            : file(std::move(file)), elements(nullptr), count(static_cast<std::size_t>(count)), compare()
+        {
+            elements = reinterpret_cast<const T *>(this->file->data() + offset);
+        }
+
+    public:
+        using value_type = T;
+        using value_compare = Compare;
+        using const_reference = const T &;
+
+        /**
+         * @brief True because the elements are one contiguous array of the mapping.
+         */
+        static constexpr bool is_contiguous = true;
+
+        MappedStorage() = default;
+
+        /**
+         * @brief Maps a snapshot written by BasicMagicalContainer::save().
+         * @param path The snapshot file.
+         * @param with_primes True if the reader expects a prime index in the snapshot.
+         * @return The storage of the elements and the storage of the prime elements, sharing one mapping.
+         * @throws std::runtime_error If the file cannot be mapped or its header does not match (see snapshot::validate()).
+         *
+         * Only the header is checked, the arrays are not read, so opening costs the same for any
+         * size. The checksum is left to BasicMagicalContainer::load() on a heap storage, so the
+         * bounds and alignment checks of the header are all that stands between a corrupt file
+         * and the element pointers.
+         */
+        static std::pair<MappedStorage, MappedStorage> openSnapshot(const std::string &path, bool with_primes)
+        {
+            auto file = std::make_shared<const MappedFile>(path);
+            if (file->size() < sizeof(snapshot::Header))
+            {
+                throw std::runtime_error("Cannot read the snapshot header");
+            }
+            const auto *header = reinterpret_cast<const snapshot::Header *>(file->data());
+            snapshot::validate(*header, snapshot::elementType<T, Compare>(), file->size());
+            if (((header->flags & snapshot::has_prime_index) != 0) != with_primes)
+            {
+                throw std::runtime_error("The snapshot holds elements of another type");
+            }
+            auto aligned = [&file](std::uint64_t offset) {
+                return reinterpret_cast<std::uintptr_t>(file->data() + offset) % alignof(T) == 0;
+            };
+            if (!aligned(header->elements_offset) || !aligned(header->primes_offset))
+            {
+                throw std::runtime_error("The snapshot arrays are not aligned for the element type");
+            }
+            return {MappedStorage(file, header->elements_offset, header->element_count),
+                    MappedStorage(file, header->primes_offset, header->prime_count)};
+        }
+
+        /**
+         * @brief Returns the number of stored elements.
+         * @return The number of elements.
+         */
+        std::size_t size() const
+        {
+            return count;
+        }
+
+        /**
+         * @brief Returns the element with the given rank.
+         * @param index The rank of the element (0 is the smallest).
+         * @return The element at that rank.
+         */
+        const T &operator[](std::size_t index) const
+        {
+            return elements[index];
+        }
+
+        /**
+         * @brief Returns a pointer to the mapped, sorted array of elements.
+         * @return Pointer to the smallest element.
+         */
+        const T *data() const
+        {
+            return elements;
+        }
+
+        /**
+         * @brief Returns the rank of the first element not less than value.
+         * @param value The value to look for.
+         * @return The rank, or size() if every element is less than value.
+         */
+        std::size_t lowerBound(const T &value) const
+        {
+            return static_cast<std::size_t>(std::lower_bound(elements, elements + count, value, compare) - elements);
+        }
+
+        /**
+         * @brief Returns the rank of the first element greater than value.
+         * @param value The value to look for.
+         * @return The rank, or size() if no element is greater than value.
+         */
+        std::size_t upperBound(const T &value) const
+        {
+            return static_cast<std::size_t>(std::upper_bound(elements, elements + count, value, compare) - elements);
+        }
+    };
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_MAPPEDSTORAGE_HPP
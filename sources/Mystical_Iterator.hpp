@@ -1,8 +1,66 @@
 #ifndef CPP_EX4_PARTA_MYSTICAL_ITERATOR_HPP
 #define CPP_EX4_PARTA_MYSTICAL_ITERATOR_HPP
 
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
 namespace ariel
 {
+    /**
+     * @class Mystical_Iterator_Base
+     * @brief Statically dispatched base class of the concrete mystical iterators (CRTP).
+     *
+     * The derived iterator only provides position(), an integer that grows as the iterator
+     * advances, and endPosition(), the position of its end. All comparison operators are inline
+     * and compare positions, so comparing two iterators of the same type is a single integer
+     * comparison with no virtual call.
+     *
+     * Every iterator also compares equal to std::default_sentinel once it reaches its end, which
+     * lets loops and std::ranges algorithms stop without constructing an end() iterator.
+     *
+     * @tparam Derived The concrete iterator class.
+     */
+    template <typename Derived>
+    class Mystical_Iterator_Base
+    {
+    public:
+        friend bool operator==(const Derived &lhs, const Derived &rhs)
+        {
+            return lhs.position() == rhs.position();
+        }
+
+        friend bool operator!=(const Derived &lhs, const Derived &rhs)
+        {
+            return lhs.position() != rhs.position();
+        }
+
+        friend bool operator<(const Derived &lhs, const Derived &rhs)
+        {
+            return lhs.position() < rhs.position();
+        }
+
+        friend bool operator>(const Derived &lhs, const Derived &rhs)
+        {
+            return lhs.position() > rhs.position();
+        }
+
+        friend bool operator<=(const Derived &lhs, const Derived &rhs)
+        {
+            return lhs.position() <= rhs.position();
+        }
+
+        friend bool operator>=(const Derived &lhs, const Derived &rhs)
+        {
+            return lhs.position() >= rhs.position();
+        }
+
+        friend bool operator==(const Derived &iterator, std::default_sentinel_t)
+        {
+            return iterator.position() == iterator.endPosition();
+        }
+    };
+
     /**
      * @class Mystical_Iterator
      * @brief Abstract base class for mystical iterators.
@@ -11,7 +69,9 @@ namespace ariel
      * It provides pure virtual functions for comparison operators and default implementations for the special member functions.
      * Derived classes must implement the comparison operators.
      *
-     * @note This class is meant to be inherited and extended by concrete iterator classes.
+     * @note The concrete iterators no longer derive from this class. It is the type-erased interface for
+     * code that has to handle iterators of different kinds through one reference; wrap a concrete iterator
+     * in an Erased_Iterator to obtain one.
      */
     class Mystical_Iterator
     {
@@ -80,6 +140,77 @@ namespace ariel
          */
         Mystical_Iterator &operator=(Mystical_Iterator &&other) = default;
     };
+
+    /**
+     * @class Erased_Iterator
+     * @brief Adapter exposing a concrete iterator through the polymorphic Mystical_Iterator interface.
+     *
+     * Comparisons go through a virtual call and a dynamic_cast, and throw when the other iterator is of
+     * a different kind or iterates over a different container.
+     *
+     * @tparam Iterator The concrete iterator type, which provides position() and container().
+     */
+    template <typename Iterator>
+    class Erased_Iterator : public Mystical_Iterator
+    {
+    private:
+        Iterator iterator; /**< The wrapped iterator. */
+
+        /**
+         * @brief Checks that the other iterator can be compared with this one.
+         * @param other The other Mystical_Iterator.
+         * @return The other iterator, with its concrete type.
+         * @throws std::runtime_error if the iterators are of different types or point to different containers.
+         */
+        const Erased_Iterator &comparable(const Mystical_Iterator &other) const
+        {
+            const auto *other_ptr = dynamic_cast<const Erased_Iterator *>(&other);
+
+            if (other_ptr == nullptr)
+                throw std::runtime_error("Cannot compare iterators of different types");
+
+            if (iterator.container() != other_ptr->iterator.container())
+                throw std::runtime_error("Iterators are pointing at different containers");
+
+            return *other_ptr;
+        }
+
+    public:
+        /**
+         * @brief Wraps a concrete iterator.
+         * @param iterator The iterator to wrap.
+         */
+        explicit Erased_Iterator(Iterator iterator) : iterator(std::move(iterator)) {}
+
+        /**
+         * @brief Returns the wrapped iterator.
+         * @return Reference to the wrapped iterator.
+         */
+        Iterator &get()
+        {
+            return iterator;
+        }
+
+        bool operator==(const Mystical_Iterator &other) const override
+        {
+            return iterator.position() == comparable(other).iterator.position();
+        }
+
+        bool operator!=(const Mystical_Iterator &other) const override
+        {
+            return iterator.position() != comparable(other).iterator.position();
+        }
+
+        bool operator<(const Mystical_Iterator &other) const override
+        {
+            return iterator.position() < comparable(other).iterator.position();
+        }
+
+        bool operator>(const Mystical_Iterator &other) const override
+        {
+            return iterator.position() > comparable(other).iterator.position();
+        }
+    };
 }
 
 #endif // CPP_EX4_PARTA_MYSTICAL_ITERATOR_HPP
@@ -0,0 +1,110 @@
+#ifndef CPP_EX4_PARTA_PARALLELTRAVERSAL_HPP
+#define CPP_EX4_PARTA_PARALLELTRAVERSAL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace ariel
+{
+    /**
+     * @brief The orders in which a MagicalContainer can be traversed.
+     */
+    enum class TraversalOrder
+    {
+        Ascending, /**< Every element, smallest first (AscendingIterator). */
+        SideCross, /**< Every element, alternating between both ends (SideCrossIterator). */
+        Prime      /**< The prime elements only, smallest first (PrimeIterator). */
+    };
+
+    /**
+     * @brief The fewest elements handed to one worker.
+     *
+     * Starting and joining a thread costs some 20 microseconds, about as long as visiting this
+     * many elements, so smaller chunks would spend more time on their thread than on their work.
+     */
+    constexpr std::size_t min_chunk_elements = std::size_t{1} << 14U;
+
+    /**
+     * @brief Returns the number of workers to use for a traversal.
+     * @param threads The requested number of workers, 0 for one per hardware thread.
+     * @param elements The number of elements to visit.
+     * @return The number of workers, at least 1 and at most one per min_chunk_elements elements,
+     * so a traversal of fewer than twice min_chunk_elements runs on the calling thread alone.
+     */
+    inline std::size_t workerCount(std::size_t threads, std::size_t elements)
+    {
+        if (threads == 0)
+        {
+            threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+        return std::max<std::size_t>(1, std::min(threads, elements / min_chunk_elements));
+    }
+
+    /**
+     * @brief Splits a number of positions into balanced, non-empty chunks.
+     * @param total The number of positions.
+     * @param count The requested number of chunks.
+     * @return The chunk boundaries, from 0 to total.
+     */
+    inline std::vector<std::size_t> chunkBoundaries(std::size_t total, std::size_t count)
+    {
+        count = std::max<std::size_t>(1, std::min(count, total));
+        std::vector<std::size_t> boundaries;
+        boundaries.reserve(count + 1);
+        for (std::size_t chunk = 0; chunk <= count; ++chunk)
+        {
+            boundaries.push_back(total * chunk / count);
+        }
+        return boundaries;
+    }
+
+    /**
+     * @brief Runs a callable on every chunk, one worker thread per chunk.
+     * @param chunks The chunks to process.
+     * @param function The callable, invoked concurrently with one chunk each time.
+     * @throws Any exception thrown by the callable is rethrown once every worker has finished.
+     *
+     * The first chunk is processed on the calling thread, so a single chunk starts no thread.
+     */
+    template <typename Chunk, typename Function>
+    void runInParallel(const std::vector<Chunk> &chunks, Function &function)
+    {
+        std::vector<std::exception_ptr> errors(chunks.size());
+        auto work = [&chunks, &function, &errors](std::size_t chunk) {
+            try
+            {
+                function(chunks[chunk]);
+            }
+            catch (...)
+            {
+                errors[chunk] = std::current_exception();
+            }
+        };
+
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(chunks.size());
+            for (std::size_t chunk = 1; chunk < chunks.size(); ++chunk)
+            {
+                workers.emplace_back(work, chunk);
+            }
+            if (!chunks.empty())
+            {
+                work(0);
+            }
+        }
+
+        for (const std::exception_ptr &error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_PARALLELTRAVERSAL_HPP
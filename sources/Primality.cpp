@@ -0,0 +1,335 @@
+#include "Primality.hpp"
+#include "Aggregates.hpp"
+#include <array>
+#include <limits>
+#include "SimdTarget.hpp"
+
+using namespace ariel;
+
+namespace
+{
+    /**
+     * @brief The primes of the trial division wheel.
+     */
+    constexpr std::array<std::uint32_t, 12> wheel_primes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+
+    /**
+     * @brief Every composite below this bound has a factor in wheel_primes.
+     */
+    constexpr std::uint32_t wheel_limit = 41 * 41;
+
+    /**
+     * @brief Multiplies two residues modulo a 64-bit modulus.
+     * @param lhs The first factor, below modulus.
+     * @param rhs The second factor, below modulus.
+     * @param modulus The modulus.
+     * @return lhs * rhs mod modulus.
+     *
+     * Uses a 128-bit product where the compiler has one. 32-bit targets have no 128-bit type,
+     * so the product is built by doubling and adding instead, each step reduced without overflow.
+     */
+    std::uint64_t mulMod(std::uint64_t lhs, std::uint64_t rhs, std::uint64_t modulus)
+    {
+#if defined(__SIZEOF_INT128__)
+        return static_cast<std::uint64_t>(static_cast<unsigned __int128>(lhs) * rhs % modulus);
+#else
+        auto addMod = [modulus](std::uint64_t augend, std::uint64_t addend) {
+            return augend >= modulus - addend ? augend - (modulus - addend) : augend + addend;
+        };
+        std::uint64_t result = 0;
+        for (; rhs != 0; rhs >>= 1U)
+        {
+            if ((rhs & 1U) != 0)
+            {
+                result = addMod(result, lhs);
+            }
+            lhs = addMod(lhs, lhs);
+        }
+        return result;
+#endif
+    }
+
+    /**
+     * @class Montgomery
+     * @brief Modular arithmetic in Montgomery form for an odd 32-bit modulus, with R = 2^32.
+     *
+     * Products are computed in 64 bits and reduced without any division. The modulus must be
+     * below 2^31 so that the reduction cannot overflow, which holds for every positive int.
+     */
+    class Montgomery
+    {
+    private:
+        std::uint32_t modulus;     /**< The odd modulus n. */
+        std::uint32_t neg_inverse; /**< -n^-1 mod 2^32. */
+        std::uint32_t r_squared;   /**< R^2 mod n, used to enter Montgomery form. */
+
+    public:
+        explicit Montgomery(std::uint32_t modulus) : modulus(modulus), neg_inverse(0), r_squared(0)
+        {
+            // Newton iteration: every step doubles the number of correct low bits of n^-1
+            std::uint32_t inverse = modulus;
+            for (int i = 0; i < 4; ++i)
+            {
+                inverse *= 2 - modulus * inverse;
+            }
+            neg_inverse = 0 - inverse;
+            r_squared = static_cast<std::uint32_t>((~std::uint64_t{0} % modulus + 1) % modulus);
+        }
+
+        std::uint32_t reduce(std::uint64_t value) const
+        {
+            std::uint32_t factor = static_cast<std::uint32_t>(value) * neg_inverse;
+            auto result = static_cast<std::uint32_t>((value + std::uint64_t{factor} * modulus) >> 32);
+            return result >= modulus ? result - modulus : result;
+        }
+
+        std::uint32_t multiply(std::uint32_t lhs, std::uint32_t rhs) const
+        {
+            return reduce(std::uint64_t{lhs} * rhs);
+        }
+
+        std::uint32_t toForm(std::uint32_t value) const
+        {
+            return multiply(value % modulus, r_squared);
+        }
+
+        std::uint32_t power(std::uint32_t base, std::uint32_t exponent) const
+        {
+            std::uint32_t result = toForm(1);
+            while (exponent > 0)
+            {
+                if ((exponent & 1U) != 0)
+                {
+                    result = multiply(result, base);
+                }
+                base = multiply(base, base);
+                exponent >>= 1U;
+            }
+            return result;
+        }
+    };
+} // namespace
+
+namespace
+{
+#if MAGICAL_X86_KERNELS
+    /**
+     * @brief The inverse of every odd wheel prime p modulo 2^32.
+     *
+     * For an unsigned 32-bit n, n * inverse (mod 2^32) is at most (2^32 - 1) / p exactly when
+     * p divides n.
+     */
+    constexpr std::array<std::uint32_t, 11> odd_wheel_inverses = [] {
+        std::array<std::uint32_t, 11> inverses{};
+        for (std::size_t i = 0; i < inverses.size(); ++i)
+        {
+            std::uint32_t prime = wheel_primes[i + 1];
+            std::uint32_t inverse = prime;
+            for (int step = 0; step < 4; ++step)
+            {
+                inverse *= 2 - prime * inverse;
+            }
+            inverses[i] = inverse;
+        }
+        return inverses;
+    }();
+
+    /**
+     * @brief Appends the primes of a sequence to a vector, screening eight values at a time with AVX2.
+     * @param values The values to filter.
+     * @param primes The vector receiving the primes, in order.
+     */
+    __attribute__((target("avx2"))) void filterPrimesAvx2(std::span<const int> values, std::vector<int> &primes)
+    {
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i small_bound = _mm256_set1_epi32(static_cast<int>(wheel_limit));
+
+        std::size_t i = 0;
+        for (; i + 8 <= values.size(); i += 8)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values.data() + i));
+            __m256i composite = _mm256_cmpeq_epi32(_mm256_and_si256(block, one), _mm256_setzero_si256());
+            for (std::size_t p = 0; p < odd_wheel_inverses.size(); ++p)
+            {
+                __m256i product = _mm256_mullo_epi32(block, _mm256_set1_epi32(static_cast<int>(odd_wheel_inverses[p])));
+                __m256i limit = _mm256_set1_epi32(static_cast<int>(0xFFFFFFFFU / wheel_primes[p + 1]));
+                composite = _mm256_or_si256(composite, _mm256_cmpeq_epi32(_mm256_min_epu32(product, limit), product));
+            }
+
+            // Values below the wheel limit (negatives included) are settled by isPrime()
+            __m256i small = _mm256_cmpgt_epi32(small_bound, block);
+            __m256i survivors = _mm256_or_si256(_mm256_andnot_si256(composite, _mm256_cmpeq_epi32(block, block)), small);
+            auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(survivors)));
+            while (mask != 0)
+            {
+                auto lane = static_cast<std::size_t>(__builtin_ctz(mask));
+                mask &= mask - 1;
+                int value = values[i + lane];
+                bool prime = value < static_cast<int>(wheel_limit) ? primality::isPrime(value) : primality::millerRabin(static_cast<std::uint32_t>(value));
+                if (prime)
+                {
+                    primes.push_back(value);
+                }
+            }
+        }
+
+        for (; i < values.size(); ++i)
+        {
+            if (primality::isPrime(values[i]))
+            {
+                primes.push_back(values[i]);
+            }
+        }
+    }
+#endif
+} // namespace
+
+/**
+ * @brief Checks if a given value is prime.
+ * @param value The value to check for primality.
+ * @return True if the value is prime, false otherwise.
+ */
+bool primality::isPrime(int value)
+{
+    if (value < 2)
+    {
+        return false;
+    }
+
+    auto candidate = static_cast<std::uint32_t>(value);
+    for (std::uint32_t prime : wheel_primes)
+    {
+        if (candidate % prime == 0)
+        {
+            return candidate == prime;
+        }
+    }
+    if (candidate < wheel_limit)
+    {
+        return true;
+    }
+    return millerRabin(candidate);
+}
+
+/**
+ * @brief Deterministic Miller-Rabin test for odd values not divisible by a small prime.
+ * @param value The odd value to test, greater than 61.
+ * @return True if the value is prime, false otherwise.
+ */
+bool primality::millerRabin(std::uint32_t value)
+{
+    const Montgomery montgomery(value);
+    std::uint32_t odd_part = value - 1;
+    int twos = 0;
+    while ((odd_part & 1U) == 0)
+    {
+        odd_part >>= 1U;
+        ++twos;
+    }
+
+    const std::uint32_t one = montgomery.toForm(1);
+    const std::uint32_t minus_one = montgomery.toForm(value - 1);
+    for (std::uint32_t base : {2U, 7U, 61U})
+    {
+        std::uint32_t witness = montgomery.power(montgomery.toForm(base), odd_part);
+        if (witness == one || witness == minus_one)
+        {
+            continue;
+        }
+
+        bool composite = true;
+        for (int i = 1; i < twos && composite; ++i)
+        {
+            witness = montgomery.multiply(witness, witness);
+            composite = witness != minus_one;
+        }
+        if (composite)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Checks if a 64-bit value is prime.
+ * @param value The value to check for primality.
+ * @return True if the value is prime, false otherwise.
+ */
+bool primality::isPrimeWide(std::uint64_t value)
+{
+    if (value <= static_cast<std::uint64_t>(std::numeric_limits<int>::max()))
+    {
+        return isPrime(static_cast<int>(value));
+    }
+    for (std::uint32_t prime : wheel_primes)
+    {
+        if (value % prime == 0)
+        {
+            return false;
+        }
+    }
+    auto multiply = [value](std::uint64_t lhs, std::uint64_t rhs) { return mulMod(lhs, rhs, value); };
+    std::uint64_t odd_part = value - 1;
+    int twos = 0;
+    while ((odd_part & 1U) == 0)
+    {
+        odd_part >>= 1U;
+        ++twos;
+    }
+
+    for (std::uint64_t base : {2ULL, 325ULL, 9375ULL, 28178ULL, 450775ULL, 9780504ULL, 1795265022ULL})
+    {
+        std::uint64_t witness = 1;
+        std::uint64_t square = base % value;
+        for (std::uint64_t exponent = odd_part; exponent > 0; exponent >>= 1U)
+        {
+            if ((exponent & 1U) != 0)
+            {
+                witness = multiply(witness, square);
+            }
+            square = multiply(square, square);
+        }
+        if (witness == 1 || witness == value - 1)
+        {
+            continue;
+        }
+
+        bool composite = true;
+        for (int i = 1; i < twos && composite; ++i)
+        {
+            witness = multiply(witness, witness);
+            composite = witness != value - 1;
+        }
+        if (composite)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the prime values of a sequence, in their original order.
+ * @param values The values to filter.
+ * @return The values that are prime.
+ */
+std::vector<int> primality::filterPrimes(std::span<const int> values)
+{
+    std::vector<int> primes;
+#if MAGICAL_X86_KERNELS
+    if (aggregates::detectedLevel() == aggregates::SimdLevel::Avx2)
+    {
+        filterPrimesAvx2(values, primes);
+        return primes;
+    }
+#endif
+    for (int value : values)
+    {
+        if (isPrime(value))
+        {
+            primes.push_back(value);
+        }
+    }
+    return primes;
+}
@@ -0,0 +1,59 @@
+#ifndef CPP_EX4_PARTA_PRIMALITY_HPP
+#define CPP_EX4_PARTA_PRIMALITY_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace ariel
+{
+    namespace primality
+    {
+        /**
+         * @brief Checks if a given value is prime.
+         * @param value The value to check for primality.
+         * @return True if the value is prime, false otherwise.
+         *
+         * Values are first screened against a wheel of small primes, which settles every
+         * value below 41 * 41 and most composites. The remaining candidates go through a
+         * deterministic Miller-Rabin test with the bases {2, 7, 61}, which is exact for every
+         * value below 4,759,123,141 and therefore for every int.
+         */
+        bool isPrime(int value);
+
+        /**
+         * @brief Deterministic Miller-Rabin test for odd values not divisible by a small prime.
+         * @param value The odd value to test, greater than 61.
+         * @return True if the value is prime, false otherwise.
+         *
+         * Exposed separately so callers that already screened small factors can skip the wheel.
+         */
+        bool millerRabin(std::uint32_t value);
+
+        /**
+         * @brief Checks if a 64-bit value is prime.
+         * @param value The value to check for primality.
+         * @return True if the value is prime, false otherwise.
+         *
+         * Values that fit in an int go through isPrime(). Larger ones are screened by the same
+         * wheel and confirmed by Miller-Rabin with the seven bases of Jim Sinclair, which is
+         * exact for every 64-bit value. Products are reduced through 128-bit arithmetic.
+         */
+        bool isPrimeWide(std::uint64_t value);
+
+        /**
+         * @brief Returns the prime values of a sequence, in their original order.
+         * @param values The values to filter.
+         * @return The values that are prime.
+         *
+         * On CPUs with AVX2 the values are screened eight at a time: a lane survives unless it is
+         * even or divisible by another wheel prime, which is tested without any division by
+         * multiplying with the prime's inverse modulo 2^32. Only the survivors, typically a fifth
+         * of random input, get a scalar Miller-Rabin confirmation. Other CPUs test every value
+         * with isPrime().
+         */
+        std::vector<int> filterPrimes(std::span<const int> values);
+    } // namespace primality
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_PRIMALITY_HPP
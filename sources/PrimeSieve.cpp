@@ -0,0 +1,198 @@
+#include "PrimeSieve.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+using namespace ariel;
+
+namespace
+{
+    constexpr std::size_t segment_odds = std::size_t{1} << 18U;            /**< Odd numbers covered by one segment. */
+    constexpr std::size_t segment_words = segment_odds / 64;              /**< 64-bit words per segment (32 KiB). */
+    constexpr std::size_t segment_bytes = segment_words * sizeof(std::uint64_t);
+    constexpr std::uint64_t max_value = std::uint64_t{1} << 31U;          /**< Every non-negative int is below this. */
+
+    /**
+     * @struct SieveState
+     * @brief The shared bitmap. A set bit marks an odd composite (or 1).
+     *
+     * The segment table is sized once by PrimeSieve::enable(). Segments are filled in order under
+     * the mutex and published through ready_segments, so readers never take the lock.
+     */
+    struct SieveState
+    {
+        std::atomic<bool> enabled{false};
+        std::atomic<std::size_t> ready_segments{0};
+        std::vector<std::unique_ptr<std::uint64_t[]>> segments;
+        std::vector<std::uint32_t> base_primes; /**< Odd primes up to the square root of the sieved range. */
+        std::mutex grow_mutex;
+    };
+
+    SieveState &state()
+    {
+        static SieveState sieve_state;
+        return sieve_state;
+    }
+
+    /**
+     * @brief Computes the odd primes up to limit with a plain sieve of Eratosthenes.
+     * @param limit The largest value to consider.
+     * @return The odd primes not greater than limit.
+     */
+    std::vector<std::uint32_t> oddPrimesUpTo(std::uint32_t limit)
+    {
+        std::vector<bool> composite(limit + 1, false);
+        std::vector<std::uint32_t> primes;
+        for (std::uint32_t value = 3; value <= limit; value += 2)
+        {
+            if (composite[value])
+            {
+                continue;
+            }
+            primes.push_back(value);
+            for (std::uint64_t multiple = std::uint64_t{value} * value; multiple <= limit; multiple += 2 * value)
+            {
+                composite[multiple] = true;
+            }
+        }
+        return primes;
+    }
+
+    /**
+     * @brief Sieves one segment of odd numbers.
+     * @param sieve_state The shared sieve.
+     * @param segment The index of the segment to build.
+     * @return The bitmap of the segment.
+     */
+    std::unique_ptr<std::uint64_t[]> sieveSegment(const SieveState &sieve_state, std::size_t segment)
+    {
+        auto bits = std::make_unique<std::uint64_t[]>(segment_words);
+        const std::uint64_t first_odd_index = std::uint64_t{segment} * segment_odds;
+        const std::uint64_t low = 2 * first_odd_index + 1;
+        const std::uint64_t high = low + 2 * segment_odds;
+
+        if (segment == 0)
+        {
+            bits[0] |= 1U; // 1 is not prime
+        }
+        for (std::uint32_t prime : sieve_state.base_primes)
+        {
+            std::uint64_t square = std::uint64_t{prime} * prime;
+            if (square >= high)
+            {
+                break;
+            }
+            // First odd multiple of prime inside the segment, never below prime^2
+            std::uint64_t start = std::max(square, (low + prime - 1) / prime * prime);
+            if (start % 2 == 0)
+            {
+                start += prime;
+            }
+            for (std::uint64_t multiple = start; multiple < high; multiple += 2 * std::uint64_t{prime})
+            {
+                std::uint64_t bit = (multiple - low) / 2;
+                bits[bit / 64] |= std::uint64_t{1} << (bit % 64);
+            }
+        }
+        return bits;
+    }
+} // namespace
+
+/**
+ * @brief Enables the shared sieve.
+ * @param memory_limit The maximum number of bytes the bitmap may grow to. It covers
+ * 16 values per byte, so the default of 16 MiB answers every value below 2^28.
+ *
+ * Nothing is sieved yet; segments are built by the first lookups that need them.
+ * Enabling an already enabled sieve resets it with the new ceiling.
+ */
+void PrimeSieve::enable(std::size_t memory_limit)
+{
+    SieveState &sieve_state = state();
+    std::lock_guard<std::mutex> lock(sieve_state.grow_mutex);
+
+    std::uint64_t covered = std::min<std::uint64_t>(std::uint64_t{memory_limit / segment_bytes} * segment_odds * 2, max_value);
+    auto root = static_cast<std::uint32_t>(std::sqrt(static_cast<double>(covered))) + 1;
+
+    sieve_state.enabled.store(false, std::memory_order_release);
+    sieve_state.ready_segments.store(0, std::memory_order_release);
+    sieve_state.segments.clear();
+    sieve_state.segments.resize(static_cast<std::size_t>(covered / 2 / segment_odds));
+    sieve_state.base_primes = oddPrimesUpTo(root);
+    sieve_state.enabled.store(!sieve_state.segments.empty(), std::memory_order_release);
+}
+
+/**
+ * @brief Disables the shared sieve and releases its memory.
+ */
+void PrimeSieve::disable()
+{
+    SieveState &sieve_state = state();
+    std::lock_guard<std::mutex> lock(sieve_state.grow_mutex);
+    sieve_state.enabled.store(false, std::memory_order_release);
+    sieve_state.ready_segments.store(0, std::memory_order_release);
+    sieve_state.segments.clear();
+    sieve_state.segments.shrink_to_fit();
+    sieve_state.base_primes.clear();
+}
+
+/**
+ * @brief Checks whether the shared sieve is enabled.
+ * @return True if enable() was called and the sieve was not disabled since.
+ */
+bool PrimeSieve::enabled()
+{
+    return state().enabled.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Looks a value up in the sieve, growing it if the value is within the memory ceiling.
+ * @param value The value to check for primality.
+ * @return Whether the value is prime, or std::nullopt if the sieve is disabled or the value
+ * lies beyond its ceiling.
+ */
+std::optional<bool> PrimeSieve::lookup(int value)
+{
+    SieveState &sieve_state = state();
+    if (!sieve_state.enabled.load(std::memory_order_acquire))
+    {
+        return std::nullopt;
+    }
+    if (value < 3 || value % 2 == 0)
+    {
+        return value == 2;
+    }
+
+    auto odd_index = static_cast<std::size_t>(value) / 2;
+    std::size_t segment = odd_index / segment_odds;
+    if (segment >= sieve_state.segments.size())
+    {
+        return std::nullopt;
+    }
+
+    if (segment >= sieve_state.ready_segments.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(sieve_state.grow_mutex);
+        std::size_t ready = sieve_state.ready_segments.load(std::memory_order_relaxed);
+        for (; ready <= segment; ++ready)
+        {
+            sieve_state.segments[ready] = sieveSegment(sieve_state, ready);
+            sieve_state.ready_segments.store(ready + 1, std::memory_order_release);
+        }
+    }
+
+    std::size_t bit = odd_index % segment_odds;
+    return ((sieve_state.segments[segment][bit / 64] >> (bit % 64)) & 1U) == 0;
+}
+
+/**
+ * @brief Returns the number of bytes currently used by the bitmap.
+ * @return The memory taken by the segments sieved so far.
+ */
+std::size_t PrimeSieve::memoryUsage()
+{
+    return state().ready_segments.load(std::memory_order_acquire) * segment_bytes;
+}
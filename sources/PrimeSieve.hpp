@@ -0,0 +1,34 @@
+#ifndef CPP_EX4_PARTA_PRIMESIEVE_HPP
+#define CPP_EX4_PARTA_PRIMESIEVE_HPP
+
+#include <cstddef>
+#include <optional>
+
+namespace ariel
+{
+    /**
+     * @class PrimeSieve
+     * @brief Opt-in prime bitmap shared by every MagicalContainer.
+     *
+     * Once enabled, primality of values inside the sieved range is answered with one bit lookup.
+     * The bitmap stores one bit per odd number and is built lazily, one cache-sized segment at a
+     * time, only as far as the queried values require and never beyond the configured memory
+     * ceiling. Values outside the range are left to the arithmetic test.
+     *
+     * Lookups and growth are safe from any thread. enable() and disable() are not: call them
+     * while no container is being modified or iterated.
+     */
+    class PrimeSieve
+    {
+    public:
+        static constexpr std::size_t default_memory_limit = std::size_t{16} << 20U; /**< 16 MiB, every value below 2^28. */
+
+        static void enable(std::size_t memory_limit = default_memory_limit);
+        static void disable();
+        static bool enabled();
+        static std::optional<bool> lookup(int value);
+        static std::size_t memoryUsage();
+    };
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_PRIMESIEVE_HPP
@@ -0,0 +1,824 @@
+#include "RoaringStorage.hpp"
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <iterator>
+#include "Broadword.hpp"
+using namespace ariel;
+
+namespace
+{
+    /**
+     * @brief Returns the first run of a run chunk ending at or after a low half.
+     * @param values The runs, as first and last value pairs.
+     * @param low The low 16 bits of the value.
+     * @return The index of the run, or the number of runs if every run ends before low.
+     */
+    std::size_t runEndingAtOrAfter(const std::vector<std::uint16_t> &values, std::uint32_t low)
+    {
+        std::size_t first = 0;
+        std::size_t last = values.size() / 2;
+        while (first < last)
+        {
+            std::size_t middle = first + (last - first) / 2;
+            if (values[2 * middle + 1] < low)
+            {
+                first = middle + 1;
+            }
+            else
+            {
+                last = middle;
+            }
+        }
+        return first;
+    }
+} // namespace
+
+/**
+ * @brief Constructs an empty storage.
+ */
+RoaringStorage::RoaringStorage() = default;
+
+/**
+ * @brief Constructs the storage from a vector that is already sorted.
+ * @param sorted_elements The elements, in ascending order.
+ */
+RoaringStorage::RoaringStorage(std::vector<int> sorted_elements)
+{
+    build(sorted_elements);
+}
+
+/**
+ * @brief Maps an int to an unsigned key with the same order.
+ * @param value The value.
+ * @return The value with its sign bit flipped.
+ */
+std::uint32_t RoaringStorage::encode(int value)
+{
+    return static_cast<std::uint32_t>(value) ^ 0x80000000U;
+}
+
+/**
+ * @brief Maps the high and low halves of an encoded value back to the int.
+ * @param key The high 16 bits.
+ * @param low The low 16 bits.
+ * @return The value.
+ */
+int RoaringStorage::decode(std::uint32_t key, std::uint32_t low)
+{
+    return static_cast<int>((key << 16 | low) ^ 0x80000000U);
+}
+
+/**
+ * @brief Returns the low 16 bits of the element of a chunk with the given rank.
+ * @param chunk The chunk.
+ * @param rank The rank of the element inside the chunk.
+ * @return Its low 16 bits.
+ */
+std::uint32_t RoaringStorage::selectIn(const Chunk &chunk, std::size_t rank)
+{
+    switch (chunk.kind)
+    {
+    case Kind::Array:
+        return chunk.values[rank];
+    case Kind::Bitmap:
+    {
+        auto block = static_cast<std::size_t>(std::upper_bound(chunk.ranks.begin(), chunk.ranks.end(), rank) - chunk.ranks.begin()) - 1;
+        auto remaining = static_cast<unsigned>(rank - chunk.ranks[block]);
+        for (std::size_t word = block * block_words;; ++word)
+        {
+            std::uint64_t counts = broadword::prefixCounts(chunk.words[word]);
+            auto in_word = static_cast<unsigned>(counts >> 56);
+            if (remaining < in_word)
+            {
+                return static_cast<std::uint32_t>(word * 64 + broadword::selectInWord(chunk.words[word], counts, remaining));
+            }
+            remaining -= in_word;
+        }
+    }
+    case Kind::Run:
+    {
+        auto run = static_cast<std::size_t>(std::upper_bound(chunk.ranks.begin(), chunk.ranks.end(), rank) - chunk.ranks.begin()) - 1;
+        return static_cast<std::uint32_t>(chunk.values[2 * run] + (rank - chunk.ranks[run]));
+    }
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns the number of elements of a chunk below a low half.
+ * @param chunk The chunk.
+ * @param low The low 16 bits of the value.
+ * @return The rank of the first element of the chunk not less than low.
+ */
+std::size_t RoaringStorage::rankIn(const Chunk &chunk, std::uint32_t low)
+{
+    switch (chunk.kind)
+    {
+    case Kind::Array:
+        return static_cast<std::size_t>(std::lower_bound(chunk.values.begin(), chunk.values.end(), low) - chunk.values.begin());
+    case Kind::Bitmap:
+    {
+        std::size_t word = low / 64;
+        std::size_t rank = chunk.ranks[word / block_words];
+        for (std::size_t before = word / block_words * block_words; before < word; ++before)
+        {
+            rank += broadword::ones(chunk.words[before]);
+        }
+        return rank + broadword::ones(chunk.words[word] & ((std::uint64_t{1} << (low % 64)) - 1));
+    }
+    case Kind::Run:
+    {
+        std::size_t run = runEndingAtOrAfter(chunk.values, low);
+        if (run == chunk.values.size() / 2)
+        {
+            return chunk.cardinality;
+        }
+        std::uint32_t start = chunk.values[2 * run];
+        return chunk.ranks[run] + (low > start ? low - start : 0);
+    }
+    }
+    return 0;
+}
+
+/**
+ * @brief Adds a low half to a chunk.
+ * @param chunk The chunk.
+ * @param low The low 16 bits of the value.
+ * @return True if the value was added, false if it was already there.
+ *
+ * An array that outgrows array_limit becomes a bitmap; a run list that stops paying off is
+ * laid out again.
+ */
+bool RoaringStorage::insertInto(Chunk &chunk, std::uint32_t low)
+{
+    switch (chunk.kind)
+    {
+    case Kind::Array:
+    {
+        auto iter = std::lower_bound(chunk.values.begin(), chunk.values.end(), low);
+        if (iter != chunk.values.end() && *iter == low)
+        {
+            return false;
+        }
+        chunk.values.insert(iter, static_cast<std::uint16_t>(low));
+        ++chunk.cardinality;
+        if (chunk.cardinality > array_limit)
+        {
+            fillChunk(chunk, lowsOf(chunk));
+        }
+        return true;
+    }
+    case Kind::Bitmap:
+    {
+        std::uint64_t bit = std::uint64_t{1} << (low % 64);
+        if ((chunk.words[low / 64] & bit) != 0)
+        {
+            return false;
+        }
+        chunk.words[low / 64] |= bit;
+        ++chunk.cardinality;
+        for (std::size_t block = low / 64 / block_words + 1; block < chunk.ranks.size(); ++block)
+        {
+            ++chunk.ranks[block];
+        }
+        return true;
+    }
+    case Kind::Run:
+    {
+        std::size_t run = runEndingAtOrAfter(chunk.values, low);
+        std::size_t runs = chunk.values.size() / 2;
+        if (run < runs && chunk.values[2 * run] <= low)
+        {
+            return false;
+        }
+        bool joins_previous = run > 0 && chunk.values[2 * run - 1] + 1U == low;
+        bool joins_next = run < runs && chunk.values[2 * run] == low + 1;
+        auto value = static_cast<std::uint16_t>(low);
+        auto at = chunk.values.begin() + static_cast<std::ptrdiff_t>(2 * run);
+        if (joins_previous && joins_next)
+        {
+            chunk.values[2 * run - 1] = chunk.values[2 * run + 1];
+            chunk.values.erase(at, at + 2);
+        }
+        else if (joins_previous)
+        {
+            chunk.values[2 * run - 1] = value;
+        }
+        else if (joins_next)
+        {
+            chunk.values[2 * run] = value;
+        }
+        else
+        {
+            chunk.values.insert(at, {value, value});
+        }
+        ++chunk.cardinality;
+        relayoutRuns(chunk);
+        return true;
+    }
+    }
+    return false;
+}
+
+/**
+ * @brief Removes a low half from a chunk.
+ * @param chunk The chunk.
+ * @param low The low 16 bits of the value.
+ * @return True if the value was removed, false if it was not there.
+ *
+ * A bitmap that drops to array_limit elements becomes an array again.
+ */
+bool RoaringStorage::eraseFrom(Chunk &chunk, std::uint32_t low)
+{
+    switch (chunk.kind)
+    {
+    case Kind::Array:
+    {
+        auto iter = std::lower_bound(chunk.values.begin(), chunk.values.end(), low);
+        if (iter == chunk.values.end() || *iter != low)
+        {
+            return false;
+        }
+        chunk.values.erase(iter);
+        --chunk.cardinality;
+        return true;
+    }
+    case Kind::Bitmap:
+    {
+        std::uint64_t bit = std::uint64_t{1} << (low % 64);
+        if ((chunk.words[low / 64] & bit) == 0)
+        {
+            return false;
+        }
+        chunk.words[low / 64] &= ~bit;
+        --chunk.cardinality;
+        for (std::size_t block = low / 64 / block_words + 1; block < chunk.ranks.size(); ++block)
+        {
+            --chunk.ranks[block];
+        }
+        if (chunk.cardinality <= array_limit)
+        {
+            fillChunk(chunk, lowsOf(chunk));
+        }
+        return true;
+    }
+    case Kind::Run:
+    {
+        std::size_t run = runEndingAtOrAfter(chunk.values, low);
+        if (run == chunk.values.size() / 2 || chunk.values[2 * run] > low)
+        {
+            return false;
+        }
+        std::uint16_t start = chunk.values[2 * run];
+        std::uint16_t end = chunk.values[2 * run + 1];
+        auto at = chunk.values.begin() + static_cast<std::ptrdiff_t>(2 * run);
+        if (start == end)
+        {
+            chunk.values.erase(at, at + 2);
+        }
+        else if (low == start)
+        {
+            ++chunk.values[2 * run];
+        }
+        else if (low == end)
+        {
+            --chunk.values[2 * run + 1];
+        }
+        else
+        {
+            chunk.values[2 * run + 1] = static_cast<std::uint16_t>(low - 1);
+            chunk.values.insert(at + 2, {static_cast<std::uint16_t>(low + 1), end});
+        }
+        --chunk.cardinality;
+        relayoutRuns(chunk);
+        return true;
+    }
+    }
+    return false;
+}
+
+/**
+ * @brief Checks if a run list is the smallest layout for a chunk.
+ * @param runs The number of runs.
+ * @param cardinality The number of elements.
+ * @return True if the runs take less memory than both an array and a bitmap.
+ *
+ * An array takes 2 bytes per element (up to array_limit elements), a bitmap 8 KiB, a run list 4 bytes per run.
+ */
+bool RoaringStorage::runsPayOff(std::size_t runs, std::size_t cardinality)
+{
+    std::size_t bitmap_bytes = bitmap_words * sizeof(std::uint64_t);
+    std::size_t array_bytes = cardinality <= array_limit ? cardinality * sizeof(std::uint16_t) : bitmap_bytes;
+    return runs * 2 * sizeof(std::uint16_t) < std::min(array_bytes, bitmap_bytes);
+}
+
+/**
+ * @brief Re-indexes a run chunk after an update, or lays it out again if runs no longer pay off.
+ * @param chunk The run chunk.
+ */
+void RoaringStorage::relayoutRuns(Chunk &chunk)
+{
+    if (runsPayOff(chunk.values.size() / 2, chunk.cardinality))
+    {
+        indexChunk(chunk);
+    }
+    else
+    {
+        fillChunk(chunk, lowsOf(chunk));
+    }
+}
+
+/**
+ * @brief Lays out a chunk in the smallest of the three layouts for its elements.
+ * @param chunk The chunk, whose key is kept.
+ * @param lows The low 16 bits of its elements, sorted and distinct.
+ */
+void RoaringStorage::fillChunk(Chunk &chunk, const std::vector<std::uint16_t> &lows)
+{
+    std::size_t runs = 0;
+    for (std::size_t i = 0; i < lows.size(); ++i)
+    {
+        if (i == 0 || lows[i] != lows[i - 1] + 1)
+        {
+            ++runs;
+        }
+    }
+    chunk.cardinality = static_cast<std::uint32_t>(lows.size());
+    chunk.values.clear();
+    chunk.words.clear();
+    if (runsPayOff(runs, lows.size()))
+    {
+        chunk.kind = Kind::Run;
+        for (std::size_t i = 0; i < lows.size(); ++i)
+        {
+            if (i == 0 || lows[i] != lows[i - 1] + 1)
+            {
+                chunk.values.push_back(lows[i]);
+                chunk.values.push_back(lows[i]);
+            }
+            else
+            {
+                chunk.values.back() = lows[i];
+            }
+        }
+    }
+    else if (lows.size() <= array_limit)
+    {
+        chunk.kind = Kind::Array;
+        chunk.values = lows;
+    }
+    else
+    {
+        chunk.kind = Kind::Bitmap;
+        chunk.words.assign(bitmap_words, 0);
+        for (std::uint16_t low : lows)
+        {
+            chunk.words[low / 64U] |= std::uint64_t{1} << (low % 64U);
+        }
+    }
+    indexChunk(chunk);
+}
+
+/**
+ * @brief Recomputes the rank entries of a chunk from its contents.
+ * @param chunk The chunk.
+ */
+void RoaringStorage::indexChunk(Chunk &chunk)
+{
+    chunk.ranks.clear();
+    std::size_t running = 0;
+    if (chunk.kind == Kind::Bitmap)
+    {
+        chunk.ranks.reserve(bitmap_words / block_words);
+        for (std::size_t word = 0; word < bitmap_words; ++word)
+        {
+            if (word % block_words == 0)
+            {
+                chunk.ranks.push_back(static_cast<std::uint16_t>(running));
+            }
+            running += broadword::ones(chunk.words[word]);
+        }
+    }
+    else if (chunk.kind == Kind::Run)
+    {
+        chunk.ranks.reserve(chunk.values.size() / 2);
+        for (std::size_t run = 0; run < chunk.values.size() / 2; ++run)
+        {
+            chunk.ranks.push_back(static_cast<std::uint16_t>(running));
+            running += chunk.values[2 * run + 1] - chunk.values[2 * run] + 1U;
+        }
+    }
+}
+
+/**
+ * @brief Decodes the low halves of the elements of a chunk.
+ * @param chunk The chunk.
+ * @return The low 16 bits of its elements, in ascending order.
+ */
+std::vector<std::uint16_t> RoaringStorage::lowsOf(const Chunk &chunk)
+{
+    std::vector<std::uint16_t> lows;
+    lows.reserve(chunk.cardinality);
+    switch (chunk.kind)
+    {
+    case Kind::Array:
+        lows = chunk.values;
+        break;
+    case Kind::Bitmap:
+        for (std::size_t word = 0; word < bitmap_words; ++word)
+        {
+            for (std::uint64_t bits = chunk.words[word]; bits != 0; bits &= bits - 1)
+            {
+                lows.push_back(static_cast<std::uint16_t>(word * 64 + static_cast<unsigned>(std::countr_zero(bits))));
+            }
+        }
+        break;
+    case Kind::Run:
+        for (std::size_t run = 0; run < chunk.values.size() / 2; ++run)
+        {
+            for (std::uint32_t low = chunk.values[2 * run]; low <= chunk.values[2 * run + 1]; ++low)
+            {
+                lows.push_back(static_cast<std::uint16_t>(low));
+            }
+        }
+        break;
+    }
+    return lows;
+}
+
+/**
+ * @brief Returns the first chunk whose key is not less than a key.
+ * @param key The high 16 bits of a value.
+ * @return The index of the chunk, or the number of chunks.
+ */
+std::size_t RoaringStorage::chunkAt(std::uint32_t key) const
+{
+    auto iter = std::lower_bound(chunks.begin(), chunks.end(), key, [](const Chunk &chunk, std::uint32_t wanted) { return chunk.key < wanted; });
+    return static_cast<std::size_t>(iter - chunks.begin());
+}
+
+/**
+ * @brief Recomputes the number of elements before every chunk.
+ */
+void RoaringStorage::countRanks()
+{
+    chunk_ranks.resize(chunks.size());
+    std::size_t running = 0;
+    for (std::size_t index = 0; index < chunks.size(); ++index)
+    {
+        chunk_ranks[index] = running;
+        running += chunks[index].cardinality;
+    }
+}
+
+/**
+ * @brief Builds the chunks and the repeats from a sorted sequence, replacing the current contents.
+ * @param sorted_elements The elements, in ascending order.
+ */
+void RoaringStorage::build(const std::vector<int> &sorted_elements)
+{
+    chunks.clear();
+    repeats.clear();
+    std::size_t extras = 0;
+    std::vector<std::uint16_t> lows;
+    for (std::size_t index = 0; index < sorted_elements.size();)
+    {
+        std::uint32_t key = encode(sorted_elements[index]) >> 16;
+        lows.clear();
+        for (; index < sorted_elements.size() && encode(sorted_elements[index]) >> 16 == key; ++index)
+        {
+            auto low = static_cast<std::uint16_t>(encode(sorted_elements[index]));
+            if (lows.empty() || lows.back() != low)
+            {
+                lows.push_back(low);
+                continue;
+            }
+            if (repeats.empty() || repeats.back().value != sorted_elements[index])
+            {
+                repeats.push_back({sorted_elements[index], 0, extras});
+            }
+            ++repeats.back().extra;
+            ++extras;
+        }
+        Chunk chunk;
+        chunk.key = static_cast<std::uint16_t>(key);
+        fillChunk(chunk, lows);
+        chunks.push_back(std::move(chunk));
+    }
+    countRanks();
+}
+
+/**
+ * @brief Decodes every element in order.
+ * @return The elements, in ascending order, each repeated value as many times as it is stored.
+ */
+std::vector<int> RoaringStorage::toVector() const
+{
+    std::vector<int> elements;
+    elements.reserve(size());
+    auto repeat = repeats.begin();
+    for (const Chunk &chunk : chunks)
+    {
+        for (std::uint16_t low : lowsOf(chunk))
+        {
+            elements.push_back(decode(chunk.key, low));
+            if (repeat != repeats.end() && repeat->value == elements.back())
+            {
+                elements.insert(elements.end(), repeat->extra, repeat->value);
+                ++repeat;
+            }
+        }
+    }
+    return elements;
+}
+
+/**
+ * @brief Returns the number of distinct values, held in the chunks.
+ * @return The number of distinct values.
+ */
+std::size_t RoaringStorage::distinctSize() const
+{
+    return chunks.empty() ? 0 : chunk_ranks.back() + chunks.back().cardinality;
+}
+
+/**
+ * @brief Returns the distinct value with the given rank.
+ * @param index The rank among the distinct values.
+ * @return The value.
+ */
+int RoaringStorage::distinctAt(std::size_t index) const
+{
+    auto chunk = static_cast<std::size_t>(std::upper_bound(chunk_ranks.begin(), chunk_ranks.end(), index) - chunk_ranks.begin()) - 1;
+    return decode(chunks[chunk].key, selectIn(chunks[chunk], index - chunk_ranks[chunk]));
+}
+
+/**
+ * @brief Returns the number of distinct values less than a value.
+ * @param value The value to look for.
+ * @return The rank among the distinct values.
+ */
+std::size_t RoaringStorage::distinctLowerBound(int value) const
+{
+    std::uint32_t encoded = encode(value);
+    std::size_t chunk = chunkAt(encoded >> 16);
+    if (chunk == chunks.size())
+    {
+        return distinctSize();
+    }
+    if (chunks[chunk].key != encoded >> 16)
+    {
+        return chunk_ranks[chunk];
+    }
+    return chunk_ranks[chunk] + rankIn(chunks[chunk], encoded & 0xFFFFU);
+}
+
+/**
+ * @brief Returns the first repeat whose value is not less than a value.
+ * @param value The value to look for.
+ * @return The index of the repeat, or the number of repeats.
+ */
+std::size_t RoaringStorage::repeatAt(int value) const
+{
+    auto iter = std::lower_bound(repeats.begin(), repeats.end(), value, [](const Repeat &repeat, int wanted) { return repeat.value < wanted; });
+    return static_cast<std::size_t>(iter - repeats.begin());
+}
+
+/**
+ * @brief Returns the number of extra copies of the values of the repeats before a given one.
+ * @param repeat The index of the repeat, or the number of repeats to count them all.
+ * @return The number of extra copies.
+ */
+std::size_t RoaringStorage::extrasBefore(std::size_t repeat) const
+{
+    if (repeat < repeats.size())
+    {
+        return repeats[repeat].extra_before;
+    }
+    return repeats.empty() ? 0 : repeats.back().extra_before + repeats.back().extra;
+}
+
+/**
+ * @brief Returns the number of stored elements.
+ * @return The number of elements, repeated copies included.
+ */
+std::size_t RoaringStorage::size() const
+{
+    return distinctSize() + extrasBefore(repeats.size());
+}
+
+/**
+ * @brief Returns the element with the given rank.
+ * @param index The rank of the element (0 is the smallest).
+ * @return The element at that rank.
+ *
+ * The copies of a repeated value take consecutive ranks, from the rank of its first copy. The
+ * last repeated value starting at or before index either covers it, or tells how many extra
+ * copies to skip to find it among the distinct values.
+ */
+int RoaringStorage::operator[](std::size_t index) const
+{
+    if (repeats.empty())
+    {
+        return distinctAt(index);
+    }
+    auto first = [this](const Repeat &repeat) { return distinctLowerBound(repeat.value) + repeat.extra_before; };
+    auto after = std::partition_point(repeats.begin(), repeats.end(), [&first, index](const Repeat &repeat) { return first(repeat) <= index; });
+    if (after == repeats.begin())
+    {
+        return distinctAt(index);
+    }
+    const Repeat &repeat = *(after - 1);
+    if (index <= first(repeat) + repeat.extra)
+    {
+        return repeat.value;
+    }
+    return distinctAt(index - repeat.extra_before - repeat.extra);
+}
+
+/**
+ * @brief Returns the rank of the first element not less than value.
+ * @param value The value to look for.
+ * @return The rank, or size() if every element is less than value.
+ */
+std::size_t RoaringStorage::lowerBound(int value) const
+{
+    return distinctLowerBound(value) + extrasBefore(repeatAt(value));
+}
+
+/**
+ * @brief Returns the rank of the first element greater than value.
+ * @param value The value to look for.
+ * @return The rank, or size() if no element is greater than value.
+ */
+std::size_t RoaringStorage::upperBound(int value) const
+{
+    return value == INT_MAX ? size() : lowerBound(value + 1);
+}
+
+/**
+ * @brief Inserts a value.
+ * @param value The value to insert.
+ *
+ * A new value changes its chunk, plus the rank counter of every later chunk. Another copy of a
+ * stored value only counts one more extra copy in its repeat.
+ */
+void RoaringStorage::insert(int value)
+{
+    if (insertDistinct(value))
+    {
+        return;
+    }
+    std::size_t repeat = repeatAt(value);
+    if (repeat == repeats.size() || repeats[repeat].value != value)
+    {
+        repeats.insert(repeats.begin() + static_cast<std::ptrdiff_t>(repeat), {value, 0, extrasBefore(repeat)});
+    }
+    ++repeats[repeat].extra;
+    for (std::size_t later = repeat + 1; later < repeats.size(); ++later)
+    {
+        ++repeats[later].extra_before;
+    }
+}
+
+/**
+ * @brief Adds a value to the chunks unless it is already there.
+ * @param value The value to add.
+ * @return True if the value was added, false if the chunks already held it.
+ */
+bool RoaringStorage::insertDistinct(int value)
+{
+    std::uint32_t encoded = encode(value);
+    std::size_t chunk = chunkAt(encoded >> 16);
+    if (chunk == chunks.size() || chunks[chunk].key != encoded >> 16)
+    {
+        std::size_t before = chunk == chunks.size() ? distinctSize() : chunk_ranks[chunk];
+        Chunk created;
+        created.key = static_cast<std::uint16_t>(encoded >> 16);
+        chunks.insert(chunks.begin() + static_cast<std::ptrdiff_t>(chunk), std::move(created));
+        chunk_ranks.insert(chunk_ranks.begin() + static_cast<std::ptrdiff_t>(chunk), before);
+    }
+    if (!insertInto(chunks[chunk], encoded & 0xFFFFU))
+    {
+        return false;
+    }
+    for (std::size_t later = chunk + 1; later < chunks.size(); ++later)
+    {
+        ++chunk_ranks[later];
+    }
+    return true;
+}
+
+/**
+ * @brief Merges an already sorted batch of values into the storage.
+ * @param sorted_values The values to insert, in ascending order.
+ *
+ * Small batches are inserted one by one; large ones rebuild the chunks from the merged sequence.
+ */
+void RoaringStorage::insertSorted(std::span<const int> sorted_values)
+{
+    if (sorted_values.size() * 8 < size())
+    {
+        for (int value : sorted_values)
+        {
+            insert(value);
+        }
+        return;
+    }
+
+    std::vector<int> current = toVector();
+    std::vector<int> merged;
+    merged.reserve(current.size() + sorted_values.size());
+    std::merge(current.begin(), current.end(), sorted_values.begin(), sorted_values.end(), std::back_inserter(merged));
+    build(merged);
+}
+
+/**
+ * @brief Removes one copy of a value.
+ * @param value The value to remove.
+ * @return True if the value was found and removed, false otherwise.
+ *
+ * An extra copy of a repeated value goes first, so the chunks only change with the last copy.
+ */
+bool RoaringStorage::erase(int value)
+{
+    std::size_t repeat = repeatAt(value);
+    if (repeat == repeats.size() || repeats[repeat].value != value)
+    {
+        return eraseDistinct(value);
+    }
+    for (std::size_t later = repeat + 1; later < repeats.size(); ++later)
+    {
+        --repeats[later].extra_before;
+    }
+    if (--repeats[repeat].extra == 0)
+    {
+        repeats.erase(repeats.begin() + static_cast<std::ptrdiff_t>(repeat));
+    }
+    return true;
+}
+
+/**
+ * @brief Removes a value from the chunks.
+ * @param value The value to remove.
+ * @return True if the chunks held the value, false otherwise.
+ */
+bool RoaringStorage::eraseDistinct(int value)
+{
+    std::uint32_t encoded = encode(value);
+    std::size_t chunk = chunkAt(encoded >> 16);
+    if (chunk == chunks.size() || chunks[chunk].key != encoded >> 16 || !eraseFrom(chunks[chunk], encoded & 0xFFFFU))
+    {
+        return false;
+    }
+    for (std::size_t later = chunk + 1; later < chunks.size(); ++later)
+    {
+        --chunk_ranks[later];
+    }
+    if (chunks[chunk].cardinality == 0)
+    {
+        chunks.erase(chunks.begin() + static_cast<std::ptrdiff_t>(chunk));
+        chunk_ranks.erase(chunk_ranks.begin() + static_cast<std::ptrdiff_t>(chunk));
+    }
+    return true;
+}
+
+/**
+ * @brief Removes every value of a sorted batch.
+ * @param sorted_values The values to remove, in ascending order. All of them must be stored.
+ *
+ * Small batches are removed one by one; large ones rebuild the chunks from the sorted difference.
+ */
+void RoaringStorage::eraseSorted(std::span<const int> sorted_values)
+{
+    if (sorted_values.size() * 8 < size())
+    {
+        for (int value : sorted_values)
+        {
+            erase(value);
+        }
+        return;
+    }
+
+    std::vector<int> current = toVector();
+    std::vector<int> remaining;
+    remaining.reserve(current.size());
+    std::set_difference(current.begin(), current.end(), sorted_values.begin(), sorted_values.end(), std::back_inserter(remaining));
+    build(remaining);
+}
+
+/**
+ * @brief Returns the memory held by the storage.
+ * @return The size of the object, its chunks and their arrays, and its repeats, in bytes.
+ */
+std::size_t RoaringStorage::bytes() const
+{
+    std::size_t total = sizeof(*this) + chunks.capacity() * sizeof(Chunk) + chunk_ranks.capacity() * sizeof(std::size_t) +
+                        repeats.capacity() * sizeof(Repeat);
+    for (const Chunk &chunk : chunks)
+    {
+        total += chunk.values.capacity() * sizeof(std::uint16_t) + chunk.words.capacity() * sizeof(std::uint64_t) +
+                 chunk.ranks.capacity() * sizeof(std::uint16_t);
+    }
+    return total;
+}
@@ -0,0 +1,122 @@
+#ifndef CPP_EX4_PARTA_ROARINGSTORAGE_HPP
+#define CPP_EX4_PARTA_ROARINGSTORAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace ariel
+{
+    /**
+     * @class RoaringStorage
+     * @brief Storage policy keeping the elements of a MagicalContainer in a roaring bitmap.
+     *
+     * The 32-bit range is cut into chunks of 2^16 values, and each chunk that holds elements
+     * picks the smallest of three layouts for its density: a sorted array of the low 16 bits
+     * (up to 4096 elements), a 65536-bit bitmap, or a list of runs of consecutive values.
+     * Insertions and removals touch one chunk: a bit flip in a bitmap, a short shift in an
+     * array or run list. This is the backend for dense subsets of a bounded range, where it
+     * uses as little as one bit per value and updates much faster than a sorted vector.
+     *
+     * A bitmap is a set, so the chunks hold every value once. The copies of a value stored more
+     * than once are counted in a side table of repeats, which makes this storage a multiset like
+     * the others. Ranks then account for the extra copies with one more binary search; the table
+     * stays empty, and costs nothing, while every value is distinct.
+     */
+    class RoaringStorage
+    {
+    private:
+        /**
+         * @brief The layout of a chunk.
+         */
+        enum class Kind : std::uint8_t
+        {
+            Array,
+            Bitmap,
+            Run
+        };
+
+        /**
+         * @struct Chunk
+         * @brief The elements sharing the same high 16 bits.
+         */
+        struct Chunk
+        {
+            std::uint16_t key = 0;             /**< The high 16 bits of the elements. */
+            Kind kind = Kind::Array;           /**< The layout of the elements. */
+            std::uint32_t cardinality = 0;     /**< The number of elements. */
+            std::vector<std::uint16_t> values; /**< Array: the low 16 bits, sorted. Run: the first and last value of each run. */
+            std::vector<std::uint64_t> words;  /**< Bitmap: the 65536 bits. */
+            std::vector<std::uint16_t> ranks;  /**< Bitmap: elements before each block of block_words words. Run: elements before each run. */
+        };
+
+        /**
+         * @struct Repeat
+         * @brief A value stored more than once.
+         */
+        struct Repeat
+        {
+            int value = 0;                /**< The value, whose first copy is in the chunks. */
+            std::size_t extra = 0;        /**< The number of copies beyond the first. */
+            std::size_t extra_before = 0; /**< The extra copies of every smaller repeated value. */
+        };
+
+        static constexpr std::uint32_t array_limit = 4096; /**< The largest array chunk; bigger ones become bitmaps. */
+        static constexpr std::size_t bitmap_words = 1024;  /**< The number of words of a bitmap chunk. */
+        static constexpr std::size_t block_words = 8;      /**< The number of bitmap words counted by one rank entry. */
+
+        std::vector<Chunk> chunks;            /**< The non-empty chunks, by ascending key. */
+        std::vector<std::size_t> chunk_ranks; /**< The number of elements before each chunk. */
+        std::vector<Repeat> repeats;          /**< The values stored more than once, by ascending value. */
+
+        static std::uint32_t encode(int value);
+        static int decode(std::uint32_t key, std::uint32_t low);
+        static std::uint32_t selectIn(const Chunk &chunk, std::size_t rank);
+        static std::size_t rankIn(const Chunk &chunk, std::uint32_t low);
+        static bool insertInto(Chunk &chunk, std::uint32_t low);
+        static bool eraseFrom(Chunk &chunk, std::uint32_t low);
+        static bool runsPayOff(std::size_t runs, std::size_t cardinality);
+        static void relayoutRuns(Chunk &chunk);
+        static void fillChunk(Chunk &chunk, const std::vector<std::uint16_t> &lows);
+        static void indexChunk(Chunk &chunk);
+        static std::vector<std::uint16_t> lowsOf(const Chunk &chunk);
+        std::size_t chunkAt(std::uint32_t key) const;
+        std::size_t distinctSize() const;
+        int distinctAt(std::size_t index) const;
+        std::size_t distinctLowerBound(int value) const;
+        bool insertDistinct(int value);
+        bool eraseDistinct(int value);
+        std::size_t repeatAt(int value) const;
+        std::size_t extrasBefore(std::size_t repeat) const;
+        void countRanks();
+        void build(const std::vector<int> &sorted_elements);
+        std::vector<int> toVector() const;
+
+    public:
+        using value_type = int;
+        using value_compare = std::less<int>;
+        using const_reference = int;
+
+        /**
+         * @brief False, elements are decoded on access and returned by value.
+         */
+        static constexpr bool is_contiguous = false;
+
+        RoaringStorage();
+        explicit RoaringStorage(std::vector<int> sorted_elements);
+
+        std::size_t size() const;
+        int operator[](std::size_t index) const;
+        std::size_t lowerBound(int value) const;
+        std::size_t upperBound(int value) const;
+        void insert(int value);
+        void insertSorted(std::span<const int> sorted_values);
+        bool erase(int value);
+        void eraseSorted(std::span<const int> sorted_values);
+        std::size_t bytes() const;
+    };
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_ROARINGSTORAGE_HPP
@@ -0,0 +1,110 @@
+#include "SetAlgebra.hpp"
+#include <bit>
+#include "SimdTarget.hpp"
+
+using namespace ariel;
+
+namespace
+{
+#if MAGICAL_X86_KERNELS
+    /**
+     * @brief Checks whether a sorted sequence holds a value more than once, eight neighbours at a time.
+     * @param values The sequence, in ascending order.
+     * @return True if two adjacent elements are equal.
+     */
+    __attribute__((target("avx2"))) bool hasRepeatsAvx2(std::span<const int> values)
+    {
+        const int *data = values.data();
+        std::size_t size = values.size();
+        std::size_t i = 0;
+        for (; i + 9 <= size; i += 8)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 1));
+            if (_mm256_testz_si256(_mm256_cmpeq_epi32(block, next), _mm256_cmpeq_epi32(block, next)) == 0)
+            {
+                return true;
+            }
+        }
+        for (; i + 1 < size; ++i)
+        {
+            if (data[i] == data[i + 1])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Intersects two sorted sequences of distinct ints, eight by eight with AVX2.
+     * @param lhs The left sequence, in ascending order, without repeated values.
+     * @param rhs The right sequence, in ascending order, without repeated values.
+     * @return The common elements, in ascending order.
+     *
+     * Each left block is compared with the eight rotations of the right block, which marks
+     * every left element present in the right block. The block with the smaller maximum cannot
+     * match anything further on the other side and is the one to advance (both if the maxima are
+     * equal). Repeated values would be matched more than once, hence the precondition.
+     */
+    __attribute__((target("avx2"))) std::vector<int> intersectDistinctAvx2(std::span<const int> lhs, std::span<const int> rhs)
+    {
+        std::vector<int> result;
+        result.reserve(std::min(lhs.size(), rhs.size()));
+        const int *left_data = lhs.data();
+        const int *right_data = rhs.data();
+        const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i + 8 <= lhs.size() && j + 8 <= rhs.size())
+        {
+            __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(left_data + i));
+            __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right_data + j));
+            __m256i found = _mm256_cmpeq_epi32(left, right);
+            for (int turn = 1; turn < 8; ++turn)
+            {
+                right = _mm256_permutevar8x32_epi32(right, rotate);
+                found = _mm256_or_si256(found, _mm256_cmpeq_epi32(left, right));
+            }
+            for (auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(found))); mask != 0; mask &= mask - 1)
+            {
+                result.push_back(left_data[i + static_cast<std::size_t>(std::countr_zero(mask))]);
+            }
+
+            int left_max = left_data[i + 7];
+            int right_max = right_data[j + 7];
+            if (left_max <= right_max)
+            {
+                i += 8;
+            }
+            if (right_max <= left_max)
+            {
+                j += 8;
+            }
+        }
+
+        // Everything matched so far is below what is left on both sides
+        std::set_intersection(lhs.begin() + static_cast<std::ptrdiff_t>(i), lhs.end(), rhs.begin() + static_cast<std::ptrdiff_t>(j),
+                              rhs.end(), std::back_inserter(result));
+        return result;
+    }
+#endif
+} // namespace
+
+std::vector<int> setalgebra::intersect(std::span<const int> lhs, std::span<const int> rhs, std::less<int> /*compare*/)
+{
+    return intersect(lhs, rhs, aggregates::detectedLevel());
+}
+
+std::vector<int> setalgebra::intersect(std::span<const int> lhs, std::span<const int> rhs, aggregates::SimdLevel level)
+{
+    level = std::min(level, aggregates::detectedLevel());
+#if MAGICAL_X86_KERNELS
+    if (level == aggregates::SimdLevel::Avx2 && !skewed(lhs.size(), rhs.size()) && !hasRepeatsAvx2(lhs) && !hasRepeatsAvx2(rhs))
+    {
+        return intersectDistinctAvx2(lhs, rhs);
+    }
+#endif
+    return intersect<int, std::less<int>>(lhs, rhs, std::less<int>());
+}
@@ -0,0 +1,234 @@
+#ifndef CPP_EX4_PARTA_SETALGEBRA_HPP
+#define CPP_EX4_PARTA_SETALGEBRA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <utility>
+#include <vector>
+#include "Aggregates.hpp"
+
+namespace ariel
+{
+    /**
+     * @brief Intersection, union and difference of sorted sequences.
+     *
+     * The sequences are multisets: a value stored a times on the left and b times on the right
+     * appears min(a, b), max(a, b) and max(a - b, 0) times in the intersection, union and
+     * difference, as with std::set_intersection, std::set_union and std::set_difference. When
+     * the left and right elements are equivalent, the left one is kept.
+     *
+     * Each operation writes its result once, into a vector reserved for the largest possible
+     * output. When one side is more than skew_ratio times smaller, every element of the small
+     * side is located in the large one by galloping from the previous match, which costs
+     * O(small * log(large / small)) instead of O(small + large).
+     */
+    namespace setalgebra
+    {
+        constexpr std::size_t skew_ratio = 32; /**< The size ratio above which the small side gallops through the large one. */
+
+        /**
+         * @brief Checks whether one side should gallop through the other.
+         * @param lhs_size The size of the left sequence.
+         * @param rhs_size The size of the right sequence.
+         * @return True if the smaller size times skew_ratio is below the larger one.
+         */
+        inline bool skewed(std::size_t lhs_size, std::size_t rhs_size)
+        {
+            return std::min(lhs_size, rhs_size) * skew_ratio < std::max(lhs_size, rhs_size);
+        }
+
+        /**
+         * @brief Returns the position of the first element not less than value, searching from a given position.
+         * @param values The sorted sequence.
+         * @param from The position to start from. Every element before it must be less than value.
+         * @param value The value to look for.
+         * @param compare The ordering of the sequence.
+         * @return The position, or values.size() if every element is less than value.
+         *
+         * The probes double their distance from the start until one passes value, then the last
+         * gap is binary searched, so finding a position d elements away costs O(log d).
+         */
+        template <typename T, typename Compare>
+        std::size_t gallop(std::span<const T> values, std::size_t from, const T &value, Compare compare)
+        {
+            if (from >= values.size() || !compare(values[from], value))
+            {
+                return from;
+            }
+            std::size_t low = from;
+            std::size_t step = 1;
+            while (low + step < values.size() && compare(values[low + step], value))
+            {
+                low += step;
+                step *= 2;
+            }
+            auto first = values.begin() + static_cast<std::ptrdiff_t>(low + 1);
+            auto last = values.begin() + static_cast<std::ptrdiff_t>(std::min(low + step, values.size()));
+            return static_cast<std::size_t>(std::lower_bound(first, last, value, compare) - values.begin());
+        }
+
+        /**
+         * @brief Intersects two sorted sequences.
+         * @param lhs The left sequence, sorted by compare.
+         * @param rhs The right sequence, sorted by compare.
+         * @param compare The ordering of both sequences.
+         * @return The elements of lhs also in rhs, sorted.
+         */
+        template <typename T, typename Compare>
+        std::vector<T> intersect(std::span<const T> lhs, std::span<const T> rhs, Compare compare)
+        {
+            std::vector<T> result;
+            result.reserve(std::min(lhs.size(), rhs.size()));
+            if (!skewed(lhs.size(), rhs.size()))
+            {
+                std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(result), compare);
+                return result;
+            }
+
+            bool small_is_left = lhs.size() < rhs.size();
+            std::span<const T> small = small_is_left ? lhs : rhs;
+            std::span<const T> large = small_is_left ? rhs : lhs;
+            std::size_t position = 0;
+            for (const T &value : small)
+            {
+                position = gallop(large, position, value, compare);
+                if (position == large.size())
+                {
+                    break;
+                }
+                if (!compare(value, large[position]))
+                {
+                    result.push_back(small_is_left ? value : large[position]);
+                    ++position;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief Unites two sorted sequences.
+         * @param lhs The left sequence, sorted by compare.
+         * @param rhs The right sequence, sorted by compare.
+         * @param compare The ordering of both sequences.
+         * @return The elements of either sequence, sorted.
+         *
+         * With skewed sizes the runs of the large side between two elements of the small side
+         * are located by galloping and copied in bulk.
+         */
+        template <typename T, typename Compare>
+        std::vector<T> unite(std::span<const T> lhs, std::span<const T> rhs, Compare compare)
+        {
+            std::vector<T> result;
+            result.reserve(lhs.size() + rhs.size());
+            if (!skewed(lhs.size(), rhs.size()))
+            {
+                std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(result), compare);
+                return result;
+            }
+
+            bool small_is_left = lhs.size() < rhs.size();
+            std::span<const T> small = small_is_left ? lhs : rhs;
+            std::span<const T> large = small_is_left ? rhs : lhs;
+            std::size_t position = 0;
+            for (const T &value : small)
+            {
+                std::size_t next = gallop(large, position, value, compare);
+                result.insert(result.end(), large.begin() + static_cast<std::ptrdiff_t>(position),
+                              large.begin() + static_cast<std::ptrdiff_t>(next));
+                position = next;
+                if (position < large.size() && !compare(value, large[position]))
+                {
+                    result.push_back(small_is_left ? value : large[position]);
+                    ++position;
+                }
+                else
+                {
+                    result.push_back(value);
+                }
+            }
+            result.insert(result.end(), large.begin() + static_cast<std::ptrdiff_t>(position), large.end());
+            return result;
+        }
+
+        /**
+         * @brief Subtracts a sorted sequence from another.
+         * @param lhs The sequence to subtract from, sorted by compare.
+         * @param rhs The sequence to subtract, sorted by compare.
+         * @param compare The ordering of both sequences.
+         * @return The elements of lhs not matched in rhs, sorted.
+         */
+        template <typename T, typename Compare>
+        std::vector<T> subtract(std::span<const T> lhs, std::span<const T> rhs, Compare compare)
+        {
+            std::vector<T> result;
+            result.reserve(lhs.size());
+            if (!skewed(lhs.size(), rhs.size()))
+            {
+                std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(result), compare);
+                return result;
+            }
+
+            std::size_t position = 0;
+            if (lhs.size() < rhs.size())
+            {
+                // Few elements to keep: look each of them up in rhs
+                for (const T &value : lhs)
+                {
+                    position = gallop(rhs, position, value, compare);
+                    if (position < rhs.size() && !compare(value, rhs[position]))
+                    {
+                        ++position;
+                    }
+                    else
+                    {
+                        result.push_back(value);
+                    }
+                }
+                return result;
+            }
+
+            // Few elements to remove: copy the runs of lhs between them
+            for (const T &value : rhs)
+            {
+                std::size_t next = gallop(lhs, position, value, compare);
+                result.insert(result.end(), lhs.begin() + static_cast<std::ptrdiff_t>(position),
+                              lhs.begin() + static_cast<std::ptrdiff_t>(next));
+                position = next;
+                if (position < lhs.size() && !compare(value, lhs[position]))
+                {
+                    ++position;
+                }
+            }
+            result.insert(result.end(), lhs.begin() + static_cast<std::ptrdiff_t>(position), lhs.end());
+            return result;
+        }
+
+        /**
+         * @brief Intersects two sorted sequences of ints with the fastest kernel the running CPU supports.
+         * @param lhs The left sequence, in ascending order.
+         * @param rhs The right sequence, in ascending order.
+         * @param compare The ordering, only used to select this overload.
+         * @return The elements of lhs also in rhs, in ascending order.
+         */
+        std::vector<int> intersect(std::span<const int> lhs, std::span<const int> rhs, std::less<int> compare);
+
+        /**
+         * @brief Intersects two sorted sequences of ints with a given kernel.
+         * @param lhs The left sequence, in ascending order.
+         * @param rhs The right sequence, in ascending order.
+         * @param level The kernel to use. Levels the CPU does not support fall back to aggregates::detectedLevel().
+         * @return The elements of lhs also in rhs, in ascending order.
+         *
+         * With similar sizes and no repeated values, the AVX2 kernel compares a block of eight
+         * elements of each side against each other at once and advances the block with the
+         * smaller maximum, so it does not branch on every element. Exposed so tests and
+         * benchmarks can compare the kernels with each other.
+         */
+        std::vector<int> intersect(std::span<const int> lhs, std::span<const int> rhs, aggregates::SimdLevel level);
+    } // namespace setalgebra
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_SETALGEBRA_HPP
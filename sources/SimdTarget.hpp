@@ -0,0 +1,19 @@
+#ifndef CPP_EX4_PARTA_SIMDTARGET_HPP
+#define CPP_EX4_PARTA_SIMDTARGET_HPP
+
+/**
+ * @brief 1 when the SSE4.1 and AVX2 kernels are compiled, 0 otherwise.
+ *
+ * Internal to the kernel sources (Aggregates.cpp, Primality.cpp, SetAlgebra.cpp). The kernels
+ * use 64-bit intrinsics and are only built and tested on x86-64; every other target, 32-bit x86
+ * included, gets the portable code alone. Whether the running CPU supports them is still checked
+ * at run time through aggregates::detectedLevel().
+ */
+#if defined(__x86_64__)
+#define MAGICAL_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define MAGICAL_X86_KERNELS 0
+#endif
+
+#endif // CPP_EX4_PARTA_SIMDTARGET_HPP
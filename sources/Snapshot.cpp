@@ -0,0 +1,257 @@
+#include "Snapshot.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+using namespace ariel;
+
+namespace
+{
+    constexpr char snapshot_magic[8] = {'M', 'A', 'G', 'I', 'C', 'S', 'N', 'P'};
+    constexpr std::uint32_t native_byte_order = 0x01020304;
+
+    /**
+     * @brief Rounds an offset up to the snapshot alignment.
+     * @param offset The offset.
+     * @return The smallest multiple of snapshot::alignment not below offset.
+     */
+    std::uint64_t aligned(std::uint64_t offset)
+    {
+        return (offset + snapshot::alignment - 1) / snapshot::alignment * snapshot::alignment;
+    }
+
+    /**
+     * @brief Writes zero bytes until the stream reaches an offset.
+     * @param out The stream.
+     * @param offset The offset to pad to.
+     */
+    void padTo(std::ostream &out, std::uint64_t offset)
+    {
+        static constexpr std::array<char, snapshot::alignment> zeros{};
+        auto position = static_cast<std::uint64_t>(out.tellp());
+        out.write(zeros.data(), static_cast<std::streamsize>(offset - position));
+    }
+
+    /**
+     * @brief Flushes a file or directory to stable storage.
+     * @param path The file or directory.
+     * @param flags The open flags: O_WRONLY for a file, O_RDONLY | O_DIRECTORY for a directory.
+     * @return True if the data reached the device.
+     */
+    bool syncPath(const std::string &path, int flags)
+    {
+        int descriptor = ::open(path.c_str(), flags | O_CLOEXEC);
+        if (descriptor < 0)
+        {
+            return false;
+        }
+        bool synced = ::fsync(descriptor) == 0;
+        ::close(descriptor);
+        return synced;
+    }
+} // namespace
+
+/**
+ * @brief Adds a block of bytes to the checksum.
+ * @param data The bytes.
+ * @param size The number of bytes.
+ */
+void snapshot::Checksum::update(const void *data, std::size_t size)
+{
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes + i, 8);
+        sum += word;
+        weight += sum;
+    }
+    if (i < size)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes + i, size - i);
+        sum += word;
+        weight += sum;
+    }
+}
+
+/**
+ * @brief Returns the checksum of every block added so far.
+ * @return The checksum.
+ */
+std::uint64_t snapshot::Checksum::value() const
+{
+    return sum ^ (weight << 32U | weight >> 32U);
+}
+
+/**
+ * @brief Writes a snapshot file.
+ * @param path The file to create or overwrite.
+ * @param type The element type and ordering of the arrays.
+ * @param elements The sorted elements.
+ * @param element_count The number of elements.
+ * @param primes The prime index, ignored unless with_primes is set.
+ * @param prime_count The number of prime elements.
+ * @param with_primes True to store the prime index.
+ * @throws std::runtime_error If the file cannot be written. The previous file at path is then left as
+ * it was. Also if the directory cannot be synced after the rename: the new file is in place then,
+ * but a power loss may still bring back the old one.
+ *
+ * The snapshot is written to path + ".tmp", fsynced, renamed over path, and the directory holding
+ * it is fsynced so the rename itself is on disk. Readers see either the old file or the complete
+ * new one, a process or system crash at any point leaves one of the two under path, and a process
+ * that has the old file mapped keeps reading it: the rename replaces the name, not the mapped file.
+ */
+void snapshot::write(const std::string &path, ElementType type, const void *elements, std::uint64_t element_count,
+                     const void *primes, std::uint64_t prime_count, bool with_primes)
+{
+    std::uint32_t element_size = type.size;
+    Header header{};
+    std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+    header.version = format_version;
+    header.byte_order = native_byte_order;
+    header.element_size = element_size;
+    header.flags = with_primes ? has_prime_index : 0;
+    header.element_kind = static_cast<std::uint8_t>(type.kind);
+    header.ordering = static_cast<std::uint8_t>(type.ordering);
+    header.element_count = element_count;
+    header.prime_count = with_primes ? prime_count : 0;
+    header.elements_offset = aligned(sizeof(Header));
+    header.primes_offset = aligned(header.elements_offset + element_count * element_size);
+
+    Checksum checksum;
+    checksum.update(elements, element_count * element_size);
+    checksum.update(primes, header.prime_count * element_size);
+    header.checksum = checksum.value();
+
+    std::string temporary = path + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    padTo(out, header.elements_offset);
+    out.write(static_cast<const char *>(elements), static_cast<std::streamsize>(element_count * element_size));
+    padTo(out, header.primes_offset);
+    out.write(static_cast<const char *>(primes), static_cast<std::streamsize>(header.prime_count * element_size));
+    out.flush();
+    out.close();
+
+    // Without the fsync, the rename could reach the disk before the data and leave an empty file
+    std::error_code error;
+    bool written = out && syncPath(temporary, O_WRONLY);
+    if (written)
+    {
+        std::filesystem::rename(temporary, path, error);
+    }
+    if (!written || error)
+    {
+        std::filesystem::remove(temporary, error);
+        throw std::runtime_error("Cannot write the snapshot " + path);
+    }
+
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    if (!syncPath(directory.empty() ? "." : directory.string(), O_RDONLY | O_DIRECTORY))
+    {
+        throw std::runtime_error("Cannot sync the directory of the snapshot " + path);
+    }
+}
+
+/**
+ * @brief Checks that a snapshot header is consistent with the reader and the file.
+ * @param header The header read from the file.
+ * @param type The reader's element type and ordering.
+ * @param file_size The size of the file.
+ * @throws std::runtime_error If the file is not a snapshot, was written with another version, byte
+ * order, element type or ordering, or is too short for the arrays it announces.
+ */
+void snapshot::validate(const Header &header, ElementType type, std::uint64_t file_size)
+{
+    std::uint32_t element_size = type.size;
+    if (std::memcmp(header.magic, snapshot_magic, sizeof(header.magic)) != 0)
+    {
+        throw std::runtime_error("Not a snapshot file");
+    }
+    if (header.version != format_version)
+    {
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(header.version));
+    }
+    if (header.byte_order != native_byte_order)
+    {
+        throw std::runtime_error("The snapshot was written with another byte order");
+    }
+    if (header.element_size != element_size || header.element_kind != static_cast<std::uint8_t>(type.kind))
+    {
+        throw std::runtime_error("The snapshot holds elements of another type");
+    }
+    if (header.ordering != static_cast<std::uint8_t>(type.ordering))
+    {
+        throw std::runtime_error("The snapshot is sorted in another order");
+    }
+
+    // Written without additions or products of header fields, which a corrupt header could overflow
+    auto fits = [file_size, element_size](std::uint64_t offset, std::uint64_t count) {
+        return offset % alignment == 0 && offset <= file_size && count <= (file_size - offset) / element_size;
+    };
+    if (!fits(header.elements_offset, header.element_count) || !fits(header.primes_offset, header.prime_count))
+    {
+        throw std::runtime_error("The snapshot is truncated");
+    }
+}
+
+/**
+ * @brief Reads and validates the header of a snapshot.
+ * @param in The snapshot file, opened in binary mode.
+ * @param type The reader's element type and ordering.
+ * @return The header.
+ * @throws std::runtime_error If the file cannot be read or the header is invalid (see validate()).
+ */
+snapshot::Header snapshot::readHeader(std::istream &in, ElementType type)
+{
+    in.seekg(0, std::ios::end);
+    auto file_size = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0);
+
+    Header header{};
+    if (!in || file_size < sizeof(Header) || !in.read(reinterpret_cast<char *>(&header), sizeof(header)))
+    {
+        throw std::runtime_error("Cannot read the snapshot header");
+    }
+    validate(header, type, file_size);
+    return header;
+}
+
+/**
+ * @brief Reads one array of a snapshot and adds it to the checksum.
+ * @param in The snapshot file.
+ * @param data The destination, at least size bytes.
+ * @param size The number of bytes to read.
+ * @param offset The file offset of the array.
+ * @param checksum The checksum to update.
+ * @throws std::runtime_error If the read fails.
+ */
+void snapshot::readArray(std::istream &in, void *data, std::uint64_t size, std::uint64_t offset, Checksum &checksum)
+{
+    in.seekg(static_cast<std::streamoff>(offset));
+    if (!in.read(static_cast<char *>(data), static_cast<std::streamsize>(size)))
+    {
+        throw std::runtime_error("Cannot read the snapshot");
+    }
+    checksum.update(data, size);
+}
+
+/**
+ * @brief Checks the arrays read against the checksum stored in the header.
+ * @param header The snapshot header.
+ * @param checksum The checksum of the arrays as read.
+ * @throws std::runtime_error If they differ.
+ */
+void snapshot::verify(const Header &header, const Checksum &checksum)
+{
+    if (checksum.value() != header.checksum)
+    {
+        throw std::runtime_error("The snapshot is corrupted");
+    }
+}
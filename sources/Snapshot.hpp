@@ -0,0 +1,151 @@
+#ifndef CPP_EX4_PARTA_SNAPSHOT_HPP
+#define CPP_EX4_PARTA_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+
+namespace ariel
+{
+    namespace snapshot
+    {
+        /**
+         * @brief The current version of the snapshot format.
+         */
+        constexpr std::uint32_t format_version = 2;
+
+        /**
+         * @brief Offsets of the arrays in a snapshot are multiples of this, so they can be used in place once mapped.
+         */
+        constexpr std::uint64_t alignment = 64;
+
+        /**
+         * @struct Header
+         * @brief The first 64 bytes of a snapshot file.
+         *
+         * A snapshot stores the sorted elements of a container and, for integral elements, its
+         * prime index, each as a raw array in native byte order. The arrays start at aligned
+         * offsets and the checksum covers both of them, so a snapshot can be read back with one
+         * sequential read or mapped and used as is.
+         */
+        struct Header
+        {
+            char magic[8];                 /**< Always "MAGICSNP". */
+            std::uint32_t version;         /**< format_version of the writer. */
+            std::uint32_t byte_order;      /**< 0x01020304 as written by the writer, to detect foreign byte order. */
+            std::uint32_t element_size;    /**< sizeof the element type. */
+            std::uint16_t flags;           /**< Bit 0 is set when the snapshot holds a prime index. */
+            std::uint8_t element_kind;     /**< The ElementKind of the elements. */
+            std::uint8_t ordering;         /**< The Ordering of the elements. */
+            std::uint64_t element_count;   /**< The number of elements. */
+            std::uint64_t prime_count;     /**< The number of prime elements. */
+            std::uint64_t elements_offset; /**< File offset of the elements array. */
+            std::uint64_t primes_offset;   /**< File offset of the prime elements array. */
+            std::uint64_t checksum;        /**< Checksum of both arrays, see Checksum. */
+        };
+
+        static_assert(sizeof(Header) == 64, "The snapshot header must stay 64 bytes");
+
+        /**
+         * @brief Flag of Header::flags telling that the snapshot holds a prime index.
+         */
+        constexpr std::uint16_t has_prime_index = 1;
+
+        /**
+         * @brief How the bytes of an element are interpreted.
+         */
+        enum class ElementKind : std::uint8_t
+        {
+            Other,
+            SignedInteger,
+            UnsignedInteger,
+            FloatingPoint
+        };
+
+        /**
+         * @brief The order the elements are sorted in.
+         */
+        enum class Ordering : std::uint8_t
+        {
+            Custom,
+            Ascending,
+            Descending
+        };
+
+        /**
+         * @struct ElementType
+         * @brief The element type of a snapshot as recorded in its header.
+         *
+         * A reader only accepts a snapshot whose element type matches its own exactly: the same
+         * size alone would let uint32_t elements load as int, and ascending elements load into a
+         * descending container, both of which break the sorted order every query relies on. Two
+         * different custom orderings, or two different class types of the same size, cannot be
+         * told apart.
+         */
+        struct ElementType
+        {
+            std::uint32_t size;   /**< sizeof the element type. */
+            ElementKind kind;     /**< How its bytes are interpreted. */
+            Ordering ordering;    /**< The order of the elements. */
+        };
+
+        /**
+         * @brief Describes an element type and its ordering.
+         * @return The ElementType recorded in the header of snapshots of T sorted by Compare.
+         */
+        template <typename T, typename Compare>
+        constexpr ElementType elementType()
+        {
+            ElementKind kind = ElementKind::Other;
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                kind = ElementKind::FloatingPoint;
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                kind = std::is_signed_v<T> ? ElementKind::SignedInteger : ElementKind::UnsignedInteger;
+            }
+
+            Ordering ordering = Ordering::Custom;
+            if constexpr (std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::less<>>)
+            {
+                ordering = Ordering::Ascending;
+            }
+            else if constexpr (std::is_same_v<Compare, std::greater<T>> || std::is_same_v<Compare, std::greater<>>)
+            {
+                ordering = Ordering::Descending;
+            }
+            return {sizeof(T), kind, ordering};
+        }
+
+        /**
+         * @class Checksum
+         * @brief Fletcher-style 64-bit checksum, fed eight bytes at a time.
+         *
+         * Both running sums are plain 64-bit additions, so checksumming runs at memory speed.
+         * A block whose length is not a multiple of eight is padded with zeros.
+         */
+        class Checksum
+        {
+        private:
+            std::uint64_t sum = 0;    /**< Sum of the words. */
+            std::uint64_t weight = 0; /**< Sum of the running sums, which makes the checksum order-sensitive. */
+
+        public:
+            void update(const void *data, std::size_t size);
+            std::uint64_t value() const;
+        };
+
+        void write(const std::string &path, ElementType type, const void *elements, std::uint64_t element_count,
+                   const void *primes, std::uint64_t prime_count, bool with_primes);
+        void validate(const Header &header, ElementType type, std::uint64_t file_size);
+        Header readHeader(std::istream &in, ElementType type);
+        void readArray(std::istream &in, void *data, std::uint64_t size, std::uint64_t offset, Checksum &checksum);
+        void verify(const Header &header, const Checksum &checksum);
+    } // namespace snapshot
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_SNAPSHOT_HPP
@@ -0,0 +1,6 @@
+#include "SortedVectorStorage.hpp"
+
+namespace ariel
+{
+    template class BasicSortedVectorStorage<int>;
+} // namespace ariel
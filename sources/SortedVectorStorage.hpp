@@ -0,0 +1,198 @@
+#ifndef CPP_EX4_PARTA_SORTEDVECTORSTORAGE_HPP
+#define CPP_EX4_PARTA_SORTEDVECTORSTORAGE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace ariel
+{
+    /**
+     * @class BasicSortedVectorStorage
+     * @brief Storage policy keeping the elements of a MagicalContainer in one sorted vector.
+     *
+     * Lookups and rank access are as fast as they get (binary search, contiguous reads), while
+     * every single insertion or removal shifts the tail of the vector. This is the right backend
+     * for read-mostly containers and bulk loads.
+     *
+     * @tparam T The element type.
+     * @tparam Compare The strict weak ordering of the elements. Two elements are equal when
+     * neither compares less than the other.
+     */
+    template <typename T, typename Compare = std::less<T>>
+    class BasicSortedVectorStorage
+    {
+    private:
+        std::vector<T> elements;               /**< The elements, in ascending order. */
+        [[no_unique_address]] Compare compare; /**< The ordering of the elements. */
+
+        /**
+         * @brief Checks if two elements are equivalent under the ordering.
+         * @return True if neither element is less than the other.
+         */
+        bool equivalent(const T &lhs, const T &rhs) const
+        {
+            return !compare(lhs, rhs) && !compare(rhs, lhs);
+        }
+
+    public:
+        using value_type = T;
+        using value_compare = Compare;
+        using const_reference = const T &;
+
+        /**
+         * @brief True because the elements live in one contiguous array (see data()).
+         */
+        static constexpr bool is_contiguous = true;
+
+        BasicSortedVectorStorage() = default;
+        explicit BasicSortedVectorStorage(std::vector<T> sorted_elements);
+
+        /**
+         * @brief Returns the number of stored elements.
+         * @return The number of elements.
+         */
+        std::size_t size() const
+        {
+            return elements.size();
+        }
+
+        /**
+         * @brief Returns the element with the given rank.
+         * @param index The rank of the element (0 is the smallest).
+         * @return The element at that rank.
+         */
+        const T &operator[](std::size_t index) const
+        {
+            return elements[index];
+        }
+
+        /**
+         * @brief Returns a pointer to the contiguous, sorted array of elements.
+         * @return Pointer to the smallest element.
+         */
+        const T *data() const
+        {
+            return elements.data();
+        }
+
+        std::size_t lowerBound(const T &value) const;
+        std::size_t upperBound(const T &value) const;
+        void insert(const T &value);
+        void insertSorted(std::span<const T> sorted_values);
+        bool erase(const T &value);
+        void eraseSorted(std::span<const T> sorted_values);
+    };
+
+    /**
+     * @brief Constructs the storage from a vector that is already sorted.
+     * @param sorted_elements The elements, in ascending order. The vector is adopted as is.
+     */
+    template <typename T, typename Compare>
+    BasicSortedVectorStorage<T, Compare>::BasicSortedVectorStorage(std::vector<T> sorted_elements) : elements(std::move(sorted_elements)), compare() {}
+
+    /**
+     * @brief Returns the rank of the first element not less than value.
+     * @param value The value to look for.
+     * @return The rank, or size() if every element is less than value.
+     */
+    template <typename T, typename Compare>
+    std::size_t BasicSortedVectorStorage<T, Compare>::lowerBound(const T &value) const
+    {
+        return static_cast<std::size_t>(std::lower_bound(elements.begin(), elements.end(), value, compare) - elements.begin());
+    }
+
+    /**
+     * @brief Returns the rank of the first element greater than value.
+     * @param value The value to look for.
+     * @return The rank, or size() if no element is greater than value.
+     */
+    template <typename T, typename Compare>
+    std::size_t BasicSortedVectorStorage<T, Compare>::upperBound(const T &value) const
+    {
+        return static_cast<std::size_t>(std::upper_bound(elements.begin(), elements.end(), value, compare) - elements.begin());
+    }
+
+    /**
+     * @brief Inserts a value, keeping the elements sorted.
+     * @param value The value to insert.
+     */
+    template <typename T, typename Compare>
+    void BasicSortedVectorStorage<T, Compare>::insert(const T &value)
+    {
+        auto iter = std::lower_bound(elements.begin(), elements.end(), value, compare);
+        elements.insert(iter, value);
+    }
+
+    /**
+     * @brief Merges an already sorted batch of values into the storage.
+     * @param sorted_values The values to insert, in ascending order.
+     *
+     * The batch is appended and merged with the existing elements in one pass.
+     */
+    template <typename T, typename Compare>
+    void BasicSortedVectorStorage<T, Compare>::insertSorted(std::span<const T> sorted_values)
+    {
+        std::size_t old_size = elements.size();
+        elements.insert(elements.end(), sorted_values.begin(), sorted_values.end());
+
+        auto middle = elements.begin() + static_cast<std::ptrdiff_t>(old_size);
+        if (old_size > 0 && middle != elements.end() && compare(*middle, *(middle - 1)))
+        {
+            std::inplace_merge(elements.begin(), middle, elements.end(), compare);
+        }
+    }
+
+    /**
+     * @brief Removes a single occurrence of a value.
+     * @param value The value to remove.
+     * @return True if the value was found and removed, false otherwise.
+     */
+    template <typename T, typename Compare>
+    bool BasicSortedVectorStorage<T, Compare>::erase(const T &value)
+    {
+        auto iter = std::lower_bound(elements.begin(), elements.end(), value, compare);
+        if (iter == elements.end() || compare(value, *iter))
+        {
+            return false;
+        }
+        elements.erase(iter);
+        return true;
+    }
+
+    /**
+     * @brief Removes one occurrence of every value of a sorted batch.
+     * @param sorted_values The values to remove, in ascending order. All of them must be stored.
+     *
+     * The sorted difference is written over the vector in a single compaction pass.
+     */
+    template <typename T, typename Compare>
+    void BasicSortedVectorStorage<T, Compare>::eraseSorted(std::span<const T> sorted_values)
+    {
+        auto write = elements.begin();
+        auto remove = sorted_values.begin();
+        for (auto read = elements.begin(); read != elements.end(); ++read)
+        {
+            if (remove != sorted_values.end() && equivalent(*remove, *read))
+            {
+                ++remove;
+            }
+            else
+            {
+                *write++ = std::move(*read);
+            }
+        }
+        elements.erase(write, elements.end());
+    }
+
+    /**
+     * @brief The storage of int elements in ascending order.
+     */
+    using SortedVectorStorage = BasicSortedVectorStorage<int>;
+
+    extern template class BasicSortedVectorStorage<int>;
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_SORTEDVECTORSTORAGE_HPP
@@ -0,0 +1,132 @@
+#ifndef CPP_EX4_PARTA_VERSIONSTAMP_HPP
+#define CPP_EX4_PARTA_VERSIONSTAMP_HPP
+
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @brief Set to 1 to make iterators throw when used after their container was modified.
+ *
+ * Off unless defined explicitly; NDEBUG has no effect on it. The setting changes the layout of
+ * the iterators, so it must be the same for every translation unit of a program, including the
+ * objects holding the explicit instantiations. The Makefile passes it to every compilation.
+ */
+#ifndef MAGICAL_CHECKED_ITERATORS
+#define MAGICAL_CHECKED_ITERATORS 0
+#endif
+
+namespace ariel
+{
+    /**
+     * @class ModificationCounter
+     * @brief Version number of a container, bumped by every change to its elements.
+     *
+     * Copying a container copies its version. Assigning to a container or moving out of it
+     * bumps the version of the container whose elements changed, so no iterator created before
+     * can match it again.
+     */
+    class ModificationCounter
+    {
+    private:
+        std::uint64_t version = 0; /**< The number of modifications so far. */
+
+    public:
+        ModificationCounter() = default;
+        ModificationCounter(const ModificationCounter &other) = default;
+
+        /**
+         * @brief Takes the version of a container being moved from, and bumps that container.
+         * @param other The counter of the moved-from container.
+         */
+        ModificationCounter(ModificationCounter &&other) noexcept : version(other.version)
+        {
+            ++other.version;
+        }
+
+        /**
+         * @brief Bumps the version, since the container gets new elements.
+         * @return Reference to this counter.
+         */
+        ModificationCounter &operator=(const ModificationCounter & /* other */)
+        {
+            ++version;
+            return *this;
+        }
+
+        /**
+         * @brief Bumps the versions of both containers, since both lose or get elements.
+         * @param other The counter of the moved-from container.
+         * @return Reference to this counter.
+         */
+        ModificationCounter &operator=(ModificationCounter &&other) noexcept
+        {
+            ++version;
+            ++other.version;
+            return *this;
+        }
+
+        ~ModificationCounter() = default;
+
+        /**
+         * @brief Records one modification.
+         */
+        void bump()
+        {
+            ++version;
+        }
+
+        /**
+         * @brief Returns the current version.
+         * @return The version.
+         */
+        std::uint64_t value() const
+        {
+            return version;
+        }
+    };
+
+    /**
+     * @class VersionStamp
+     * @brief The container version an iterator was created at.
+     *
+     * With MAGICAL_CHECKED_ITERATORS the stamp is compared with the container's version every
+     * time the iterator reads or moves. Otherwise it is an empty class whose check does nothing,
+     * so the iterators have the same size and speed as without it.
+     */
+    class VersionStamp
+    {
+#if MAGICAL_CHECKED_ITERATORS
+    private:
+        std::uint64_t version = 0; /**< The version of the container when the iterator was created. */
+
+    public:
+        VersionStamp() = default;
+
+        /**
+         * @brief Stamps an iterator with the current version of its container.
+         * @param counter The container's modification counter.
+         */
+        explicit VersionStamp(const ModificationCounter &counter) : version(counter.value()) {}
+
+        /**
+         * @brief Checks that the container was not modified since the stamp was taken.
+         * @param counter The container's modification counter.
+         * @throws std::runtime_error If the container was modified.
+         */
+        void check(const ModificationCounter &counter) const
+        {
+            if (counter.value() != version)
+            {
+                throw std::runtime_error("Iterator used after the container was modified");
+            }
+        }
+#else
+    public:
+        VersionStamp() = default;
+        explicit VersionStamp(const ModificationCounter & /* counter */) {}
+        void check(const ModificationCounter & /* counter */) const {}
+#endif
+    };
+} // namespace ariel
+
+#endif // CPP_EX4_PARTA_VERSIONSTAMP_HPP